@@ -0,0 +1,133 @@
+// All code from the namespace `std` is part of the C++ standard library
+// made publically available by an ISO working group
+#include <algorithm>
+#include <sstream>
+
+// POSIX APIs for appending
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "appender.hpp"
+#include "filelock.hpp"
+#include "reader.hpp"
+#include "trace.hpp"
+
+SeedAppender::SeedAppender(std::string seeds) : _seeds(seeds) {
+    FileLock lock(_seeds + ".lock");
+    reopen();
+    scan();
+}
+
+SeedAppender::~SeedAppender() {
+    if (_fd >= 0)
+        close(_fd);
+}
+
+void SeedAppender::reopen() {
+    struct stat opened, current;
+    if (_fd >= 0 && fstat(_fd, &opened) == 0 && stat(_seeds.c_str(), &current) == 0 &&
+        opened.st_ino == current.st_ino && opened.st_dev == current.st_dev)
+        return;
+
+    if (_fd >= 0)
+        close(_fd);
+
+    _fd = open(_seeds.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    _scanned = 0;
+    _seen.clear();
+}
+
+void SeedAppender::scan() {
+    Trace::Span span("SeedAppender::scan");
+
+    // The reader maps the file, so only the new part is ever touched
+    PuzzleReader reader(_seeds, _scanned);
+    Board seed;
+    while (reader.next(seed)) {
+        // A line without a newline is still being written
+        if (reader.end() > reader.complete())
+            break;
+
+        _seen.insert(canonical(seed));
+        _scanned = reader.end();
+    }
+}
+
+std::uint64_t SeedAppender::canonical(const char *cells) {
+    char best[81], form[81];
+    std::fill(std::begin(best), std::end(best), '9' + 1);
+
+    // Try all 8 rotations and reflections (optionally transpose, then rotate 0-3 times)
+    for (int symmetry = 0; symmetry < 8; ++symmetry) {
+        char names[10] = {'0'};
+        char next = '1';
+
+        for (int i = 0; i < 81; ++i) {
+            int r = i / 9, c = i % 9;
+            if (symmetry & 4)
+                std::swap(r, c);
+            for (int k = 0; k < (symmetry & 3); ++k) {
+                int old = r;
+                r = c;
+                c = 8 - old;
+            }
+
+            // Rename numbers in the order they first appear
+            int num = cells[r * 9 + c] - '0';
+            if (names[num] == 0)
+                names[num] = next++;
+            form[i] = names[num];
+        }
+
+        if (std::lexicographical_compare(form, form + 81, best, best + 81))
+            std::copy(form, form + 81, best);
+    }
+
+    // 64-bit FNV-1a
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char cell : best) {
+        hash ^= (unsigned char) cell;
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+std::uint64_t SeedAppender::canonical(const Board &board) {
+    char cells[81];
+    for (int i = 0; i < 81; ++i)
+        cells[i] = '0' + board[i / 9][i % 9];
+
+    return canonical(cells);
+}
+
+SeedAppender::Result SeedAppender::append(const Board &board, const std::string &annotation) {
+    Trace::Span span("SeedAppender::append");
+
+    std::uint64_t hash = canonical(board);
+
+    std::ostringstream os;
+    os << board;
+    if (!annotation.empty())
+        os << ' ' << annotation;
+    os << '\n';
+    std::string record = os.str();
+
+    // Catch up on what other processes appended, then append if it is new
+    FileLock lock(_seeds + ".lock");
+    reopen();
+    scan();
+
+    if (_fd < 0)
+        return Failed;
+    if (!_seen.insert(hash).second)
+        return Duplicate;
+
+    if (write(_fd, record.data(), record.size()) != (ssize_t) record.size()) {
+        _seen.erase(hash);
+        return Failed;
+    }
+
+    return Added;
+}
@@ -0,0 +1,60 @@
+#ifndef SUDOKU_APPENDER_HPP
+#define SUDOKU_APPENDER_HPP
+
+// All code from the namespace `std` is part of the C++ standard library
+// made publically available by an ISO working group
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+
+#include "board.hpp"
+
+// Appends seeds to a seeds file that other processes may be appending to at the same time
+// Each seed is written as one whole line with a single write() to a file opened with O_APPEND,
+// while holding `<seeds>.lock`. Seeds that are the same puzzle as one already in the file
+// (with the numbers swapped around, rotated, or reflected, like `Board::generate()` does) are
+// rejected, using a set of hashes of every seed's canonical form.
+class SeedAppender {
+    private:
+        std::string _seeds; // The seeds file
+        int _fd = -1; // The seeds file, opened for appending
+        std::uint64_t _scanned = 0; // How many bytes of the seeds file are in `_seen`
+        std::unordered_set<std::uint64_t> _seen; // Canonical hashes of the seeds in the file
+
+        // Open the seeds file, starting over if it was replaced (e.g. by `-r`) since last time
+        void reopen();
+
+        // Add the seeds past `_scanned` to `_seen` (the lock must be held)
+        void scan();
+
+    public:
+        // What became of a seed passed to `append()`
+        enum Result { Added, Duplicate, Failed };
+
+        // Open the seeds file and read in the seeds already there
+        SeedAppender(std::string seeds = "seeds.dat");
+
+        // Close the seeds file
+        ~SeedAppender();
+
+        // Only one owner per file descriptor
+        SeedAppender(const SeedAppender &copy) = delete;
+        SeedAppender& operator=(const SeedAppender &copy) = delete;
+
+        // Hash of the canonical form of 81 cells ('0'-'9'): the smallest of every rotation and
+        // reflection, with the numbers renamed 1, 2, 3... in the order they first appear
+        static std::uint64_t canonical(const char *cells);
+        static std::uint64_t canonical(const Board &board);
+
+        // Append a seed, followed by a space and `annotation` if there is one
+        // Returns Duplicate if the seed is already in the file, or Failed if the file couldn't be
+        // opened or written (e.g. its directory doesn't exist)
+        Result append(const Board &board, const std::string &annotation = "");
+
+        // The number of different seeds in the file
+        std::size_t size() const {
+            return _seen.size();
+        }
+};
+
+#endif
@@ -0,0 +1,92 @@
+// All code from the namespace `std` is part of the C++ standard library
+// made publically available by an ISO working group
+#include <algorithm>
+
+#include "batch.hpp"
+#include "lanes.hpp"
+#include "trace.hpp"
+
+// Below this many boards, packing them into lanes costs more than it saves
+static constexpr std::size_t minLanes = 8;
+
+// Note which cells of a board are empty, so whatever is played in them can be taken back
+static void findEmpty(const Board &board, bool empty[81]) {
+    for (int i = 0; i < 81; ++i)
+        empty[i] = board[i / 9][i % 9] == 0;
+}
+
+// Empty the cells that were empty before (without copying the board, which allocates)
+static void restoreEmpty(Board &board, const bool empty[81]) {
+    for (int i = 0; i < 81; ++i)
+        if (empty[i])
+            board.play(i / 9, i % 9, 0);
+}
+
+// Propagate `boards` in chunks of `Lanes::width`, calling `finish(i, lanes, lane)` for each
+template<typename Finish>
+static void forEachLane(std::span<Board> boards, Finish finish) {
+    for (std::size_t first = 0; first < boards.size(); first += Lanes::width) {
+        std::size_t num = std::min(Lanes::width, boards.size() - first);
+        Lanes lanes(boards.subspan(first, num));
+
+        for (std::size_t lane = 0; lane < num; ++lane)
+            finish(first + lane, lanes, lane);
+    }
+}
+
+void solveAll(std::span<Board> boards, std::span<bool> solved) {
+    Trace::Span span("solveAll");
+
+    if (boards.size() < minLanes) {
+        for (std::size_t i = 0; i < boards.size(); ++i)
+            solved[i] = boards[i].validate() && (boards[i].full() || boards[i].solve(0, 0));
+        return;
+    }
+
+    forEachLane(boards, [&](std::size_t i, const Lanes &lanes, std::size_t lane) {
+        if (lanes.failed() & (1u << lane)) {
+            solved[i] = false;
+            return;
+        }
+
+        // Search from where propagation got stuck, leaving the board alone if that fails
+        bool empty[81];
+        findEmpty(boards[i], empty);
+        lanes.fill(lane, boards[i]);
+        solved[i] = (lanes.solved() & (1u << lane)) || boards[i].solve(0, 0);
+        if (!solved[i])
+            restoreEmpty(boards[i], empty);
+    });
+}
+
+void validateAll(std::span<const Board> boards, std::span<bool> valid) {
+    Trace::Span span("validateAll");
+
+    for (std::size_t i = 0; i < boards.size(); ++i)
+        valid[i] = boards[i].validate();
+}
+
+void countAll(std::span<Board> boards, std::span<int> counts) {
+    Trace::Span span("countAll");
+
+    if (boards.size() < minLanes) {
+        for (std::size_t i = 0; i < boards.size(); ++i)
+            counts[i] = boards[i].validate() ? boards[i].unique() : 0;
+        return;
+    }
+
+    forEachLane(boards, [&](std::size_t i, const Lanes &lanes, std::size_t lane) {
+        if (lanes.failed() & (1u << lane))
+            counts[i] = 0;
+        else if (lanes.solved() & (1u << lane))
+            counts[i] = 1;
+        else {
+            // Count from where propagation got stuck (the same solutions), then put it back
+            bool empty[81];
+            findEmpty(boards[i], empty);
+            lanes.fill(lane, boards[i]);
+            counts[i] = boards[i].unique();
+            restoreEmpty(boards[i], empty);
+        }
+    });
+}
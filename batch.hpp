@@ -0,0 +1,26 @@
+#ifndef SUDOKU_BATCH_HPP
+#define SUDOKU_BATCH_HPP
+
+// All code from the namespace `std` is part of the C++ standard library
+// made publically available by an ISO working group
+#include <span>
+
+#include "board.hpp"
+
+// Batch versions of the Board operations for working through many boards in one call
+// Nothing is allocated: results go into spans the caller provides (at least as long as `boards`)
+// Large batches are propagated 32 boards at a time (see lanes.hpp), searching only the boards
+// propagation can't finish
+
+// Solve every board in place from the cells that are filled in (unlike `Board::solve()`, which
+// resets anything that isn't fixed); solved[i] is whether boards[i] has a solution
+void solveAll(std::span<Board> boards, std::span<bool> solved);
+
+// valid[i] is whether no numbers repeat per row, column, and group of boards[i]
+void validateAll(std::span<const Board> boards, std::span<bool> valid);
+
+// counts[i] is the number of solutions to boards[i]: 0, 1, or 2 (meaning at least 2)
+// Boards with repeated numbers have no solutions
+void countAll(std::span<Board> boards, std::span<int> counts);
+
+#endif
@@ -0,0 +1,592 @@
+// All code from the namespace `std` is part of the C++ standard library
+// made publically available by an ISO working group
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <random>
+
+#include "appender.hpp"
+#include "board.hpp"
+#include "rater.hpp"
+#include "reader.hpp"
+#include "seedindex.hpp"
+#include "trace.hpp"
+
+Board::Board(const Board &copy) : _numFixed(copy._numFixed) {
+    for (int i = 0; i < 9; ++i)
+        for (int j = 0; j < 9; ++j)
+            _board[i][j] = copy[i][j];
+
+    // create a new _fixed and copy the elements of the original into it
+    _fixed = new int[_numFixed]; 
+    for (int i = 0; i < _numFixed; ++i)
+        _fixed[i] = copy._fixed[i]; 
+}
+
+Board& Board::operator=(const Board& copy) {
+    _numFixed = copy._numFixed;
+    for (int i = 0; i < 9; ++i)
+        for (int j = 0; j < 9; ++j)
+            _board[i][j] = copy[i][j];
+
+    // create a new _fixed and copy the elements of the original into it
+    delete[] _fixed;
+    _fixed = new int[_numFixed];
+    for (int i = 0; i < _numFixed; ++i)
+        _fixed[i] = copy._fixed[i];
+
+    return *this;
+}
+
+Board::Board(std::string_view serialized) {
+    PuzzleReader reader(serialized.data(), serialized.size());
+    if (!reader.next(*this))
+        clear();
+}
+
+Board::~Board() {
+    delete[] _fixed;
+}
+
+void Board::clear() {
+    delete[] _fixed;
+
+    _numFixed = 0;
+    _fixed = new int[_numFixed];
+
+    for (int i = 0; i < 9; ++i)
+        for (int j = 0; j < 9; ++j)
+            _board[i][j] = 0;
+}
+
+bool Board::fixed(int r, int c) const {
+    if (std::find(_fixed, _fixed + _numFixed, r * 9 + c) != _fixed + _numFixed)
+        return true;
+
+    return false;
+}
+
+bool Board::fix() {
+    Trace::Span span("Board::fix");
+
+    // Don't fix a board if it's not valid or has no solution
+    if (!validate() || unique() < 1)
+        return false;
+
+    // Get rid of old _fixed
+    delete[] _fixed;
+
+    // Set _numFixed to the number of non-zero elements & create a new array
+    _numFixed = count();
+    _fixed = new int[_numFixed];
+
+    // loop through and add all of the elements to be fixed to _fixed
+    int index = 0;
+    for (int i = 0; i < 9; ++i) {
+        for (int j = 0; j < 9; ++j) {
+            if (_board[i][j] != 0) {
+                _fixed[index] = i * 9 + j;
+                ++index;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool Board::play(int r, int c, int num) {
+    if (fixed(r, c))
+        return false;
+        
+    _board[r][c] = num > 0 && num < 10 ? num : 0;
+
+    return canMove(r, c, num);
+}
+
+bool Board::full() const {
+    return count() == 81;
+}
+
+int Board::count() const {
+    int count = 0;
+
+    for (int i = 0; i < 9; ++i)
+        for (int j = 0; j < 9; ++j)
+            if (_board[i][j] > 0 && _board[i][j] < 10)
+                ++count; 
+
+    return count;
+}
+
+void Board::rotate(int times) {
+    if (times == 0)
+        return;
+
+    Board old = *this; // Calls copy constructor
+
+    switch (times) {
+        case 1: // 90 deg: (x, y) -> (y, -x)
+            for (int i = 0; i < 9; ++i)
+                for (int j = 0; j < 9; ++j)
+                    _board[i][j] = old[j][8 - i];
+            break;
+        case 2: // 180 deg: (x, y) -> (-x, -y)
+            for (int i = 0; i < 9; ++i)
+                for (int j = 0; j < 9; ++j)
+                    _board[i][j] = old[8 - i][8 - j];
+            break;
+        case 3: // 270 deg: (x, y) -> (-y, x)
+            for (int i = 0; i < 9; ++i)
+                for (int j = 0; j < 9; ++j)
+                    _board[i][j] = old[8 - j][i];
+            break;
+    }
+}
+
+void Board::reflect(int axis) {
+    if (axis == 0)
+        return;
+
+    Board old = *this;
+
+    switch (axis) {
+        case 1:
+            for (int i = 0; i < 9; ++i)
+                for (int j = 0; j < 9; ++j)
+                    _board[i][j] = old[8 - i][j];
+            break;
+        case 2:
+            for (int i = 0; i < 9; ++i)
+                for (int j = 0; j < 9; ++j)
+                    _board[i][j] = old[i][8 - j];
+            break;
+        case 3:
+            for (int i = 0; i < 9; ++i)
+                for (int j = 0; j < 9; ++j)
+                    _board[i][j] = old[8 - i][8 - j];
+            break;
+    }
+}
+
+bool Board::validate() const {
+    Trace::Span span("Board::validate");
+
+    for (int i = 0; i < 9; ++i) {
+        int row[9]; 
+        int col[9];
+        int group[9];
+
+        std::copy(std::begin(_board[i]), std::end(_board[i]), std::begin(row));
+
+        for (int j = 0; j < 9; ++j) {
+            col[j] = _board[j][i];
+            group[j] = _board[(i / 3) * 3 + j / 3][(i % 3) * 3 + j % 3];
+        }
+
+        std::sort(std::begin(row), std::end(row));
+        std::sort(std::begin(col), std::end(col));
+        std::sort(std::begin(group), std::end(group));
+
+        for (int j = 1; j < 9; ++j)
+            if ((row[j] != 0 && row[j] == row[j - 1]) ||
+                (col[j] != 0 && col[j] == col[j - 1]) ||
+                (group[j] != 0 && group[j] == group[j - 1]))
+                return false;
+    } 
+
+    return true;
+}
+
+bool Board::canMove(int r, int c, int num) {
+    if (num == 0) // Can always change to 0
+        return true;
+
+    int row[9]; 
+    int col[9];
+    int group[9];
+
+    int oldVal = _board[r][c]; // To reset the board afterward
+    _board[r][c] = 0; // Clear current value bc it will be overridden
+
+    std::copy(std::begin(_board[r]), std::end(_board[r]), std::begin(row));
+
+    int g = ((r / 3) * 3 + c / 3);
+    for (int j = 0; j < 9; ++j) {
+        col[j] = _board[j][c];
+        group[j] = _board[(g / 3) * 3 + j / 3][(g % 3) * 3 + j % 3];
+    }
+
+    // Check if anything in the row, col, or group is equal to the given number
+    for (int j = 0; j < 9; ++j) {
+        if ((row[j] == num) ||
+            (col[j] == num) ||
+            (group[j] == num)) {
+            _board[r][c] = oldVal;
+            return false;
+        }
+    }
+
+    _board[r][c] = oldVal;
+    return true;
+}
+
+bool Board::solve(int row, int col) {
+    if (col > 8) {
+        // Return a solution if we are on the bottom right corner of the board
+        if (row == 8)
+            return true;
+
+        // If out of bounds by going too far to the right, wrap around to the next row
+        ++row;
+        col = 0;
+    }
+    
+    // If there's already a number, jump to the next cell
+    if (_board[row][col] > 0)
+        return solve(row, col + 1);
+
+    // Give up if asked to
+    if (step())
+        return false;
+
+    // Iterate through all options for numbers
+    for (int i = 1; i < 10; ++i) {
+        // If a number works, set it, recurse `solve()`, and reset if no solution
+        if (canMove(row, col, i)) {
+            _board[row][col] = i;
+
+            if (solve(row, col + 1))
+                return true;
+
+            _board[row][col] = 0;
+        }   
+    }
+
+    return false; // no solution
+}
+
+bool Board::solve() {
+    Trace::Span span("Board::solve");
+
+    // Reset anything that isn't fixed
+    for (int i = 0; i < 9; ++i)
+        for (int j = 0; j < 9; ++j)
+            if (_board[i][j] > 0 && !fixed(i, j))
+                _board[i][j] = 0;
+
+    // Don't solve an impossible board
+    if (!validate())
+        return false;
+    if (full())
+        return true;
+
+    return solve(0, 0);
+}
+
+int Board::unique(int row, int col, int num) {
+    if (col > 8) {
+        // If out of bounds on the bottom right corner, we found one more solution
+        if (row == 8)
+            return num + 1;
+
+        // If out of bounds on the right, go to the next row
+        ++row;
+        col = 0;
+    }
+
+    // If we find a fixed element, skip it
+    if (_board[row][col] > 0)
+        return unique(row, col + 1, num);
+
+    // Give up if asked to (the count is then incomplete)
+    if (step())
+        return num;
+
+    // Iterate through all options
+    for (int i = 1; i < 10; ++i) {
+        // If we find a valid move, go there and then check for unique solutions
+        if (canMove(row, col, i)) {
+            _board[row][col] = i;
+
+            num = unique(row, col + 1, num);
+
+            _board[row][col] = 0;
+
+            if (num > 1)
+                return num;
+        }   
+    }
+
+    return num; // Return however many we found
+}
+
+int Board::unique() {
+    Trace::Span span("Board::unique");
+
+    return unique(0, 0, 0);
+}
+
+bool Board::minimize() {
+    Trace::Span span("Board::minimize");
+
+    if (!validate() || unique() != 1)
+        return false;
+
+    // Try removing the clues in a random order
+    int cells[81], numCells = 0;
+    for (int i = 0; i < 81; ++i)
+        if (_board[i / 9][i % 9] > 0)
+            cells[numCells++] = i;
+
+    std::random_device dev;
+    std::mt19937 rng(dev());
+    std::shuffle(cells, cells + numCells, rng);
+
+    for (int i = 0; i < numCells; ++i) {
+        int r = cells[i] / 9, c = cells[i] % 9, clue = _board[r][c];
+
+        // The board is known to have one solution, which has `clue` here. Without the clue, any
+        // other solution would have to put something else here, so only look for those
+        _board[r][c] = 0;
+
+        std::uint16_t rows[9] = {}, cols[9] = {}, groups[9] = {};
+        for (int j = 0; j < 81; ++j) {
+            if (_board[j / 9][j % 9] > 0) {
+                rows[j / 9] |= 1 << (_board[j / 9][j % 9] - 1);
+                cols[j % 9] |= 1 << (_board[j / 9][j % 9] - 1);
+                groups[(j / 27) * 3 + (j % 9) / 3] |= 1 << (_board[j / 9][j % 9] - 1);
+            }
+        }
+
+        bool needed = false;
+        std::uint16_t &group = groups[(r / 3) * 3 + c / 3];
+        std::uint16_t others = ~(rows[r] | cols[c] | group | 1 << (clue - 1)) & 0x1ff;
+        for (int num = 1; num < 10 && !needed; ++num) {
+            std::uint16_t bit = 1 << (num - 1);
+            if (!(others & bit))
+                continue;
+
+            _board[r][c] = num;
+            rows[r] |= bit;
+            cols[c] |= bit;
+            group |= bit;
+            needed = solvable(rows, cols, groups);
+            rows[r] &= ~bit;
+            cols[c] &= ~bit;
+            group &= ~bit;
+        }
+
+        // Stop if aborted: an unfinished search can't tell whether the clue was needed
+        if (_progress && _progress->abort) {
+            _board[r][c] = clue;
+            break;
+        }
+
+        _board[r][c] = needed ? clue : 0;
+    }
+
+    // Only the remaining clues are fixed
+    if (_numFixed > 0)
+        fix();
+
+    return true;
+}
+
+bool Board::solvable(std::uint16_t rows[9], std::uint16_t cols[9], std::uint16_t groups[9]) {
+    // Find the empty cell with the fewest options
+    int best = -1, fewest = 10;
+    std::uint16_t options = 0;
+    for (int i = 0; i < 81 && fewest > 1; ++i) {
+        if (_board[i / 9][i % 9] > 0)
+            continue;
+
+        std::uint16_t free = ~(rows[i / 9] | cols[i % 9] | groups[(i / 27) * 3 + (i % 9) / 3]);
+        int num = std::popcount((std::uint16_t) (free & 0x1ff));
+        if (num < fewest) {
+            best = i;
+            fewest = num;
+            options = free & 0x1ff;
+        }
+    }
+
+    // A full board is a solution; a cell with no options means there isn't one
+    if (best < 0)
+        return true;
+    if (fewest == 0 || step())
+        return false;
+
+    int r = best / 9, c = best % 9;
+    std::uint16_t &group = groups[(r / 3) * 3 + c / 3];
+    for (; options; options &= options - 1) {
+        std::uint16_t bit = options & -options;
+
+        _board[r][c] = std::countr_zero(bit) + 1;
+        rows[r] |= bit;
+        cols[c] |= bit;
+        group |= bit;
+        bool found = solvable(rows, cols, groups);
+        rows[r] &= ~bit;
+        cols[c] &= ~bit;
+        group &= ~bit;
+
+        if (found) {
+            _board[r][c] = 0;
+            return true;
+        }
+    }
+
+    _board[r][c] = 0;
+    return false;
+}
+
+std::vector<Board> Board::loadSeeds(std::string file) {
+    Trace::Span span("Board::loadSeeds");
+
+    PuzzleReader reader(file);
+
+    std::vector<Board> seeds;
+    Board seed;
+    while (reader.next(seed))
+        seeds.push_back(seed);
+
+    return seeds;
+}
+
+bool Board::generate(std::string file, Difficulty difficulty) {
+    Trace::Span span("Board::generate");
+
+    SeedIndex index(file);
+    return generate(index, difficulty);
+}
+
+bool Board::generate(SeedIndex &index, Difficulty difficulty, int attempts) {
+    Trace::Span span("Board::generate");
+
+    Board seed;
+    if (index.pick(seed, difficulty)) {
+        generateFrom(seed);
+        return true;
+    }
+
+    // No seeds at all, so any new seed will do
+    if (difficulty == Difficulty::Any) {
+        *this = generateSeed(_progress);
+        return true;
+    }
+
+    // No seeds of that difficulty, so generate new seeds until one is (seeds of the harder
+    // difficulties are rare, so only a few are tried) and keep it for next time
+    Rater rater;
+    for (int i = 0; i < attempts && !(_progress && _progress->abort); ++i) {
+        seed = generateSeed(_progress);
+        Technique technique = rater.rate(seed);
+        if (difficultyOf(technique) != difficulty)
+            continue;
+
+        SeedAppender(index.file()).append(seed, techniqueName(technique));
+        *this = seed;
+        return true;
+    }
+
+    clear();
+    return false;
+}
+
+void Board::generate(const std::vector<Board> &seeds) {
+    Trace::Span span("Board::generate");
+
+    // If there are no seeds, generate a new seed
+    if (seeds.empty()) {
+        *this = generateSeed(_progress);
+        return;
+    }
+
+    // To generate better random numbers
+    std::random_device dev;
+    std::mt19937 rng(dev());
+
+    // Pick a random seed
+    std::uniform_int_distribution<std::size_t> pick(0, seeds.size() - 1);
+    generateFrom(seeds[pick(rng)]);
+}
+
+void Board::generateFrom(const Board &seed) {
+    Trace::Span span("Board::generateFrom");
+
+    // To generate better random numbers
+    std::random_device dev;
+    std::mt19937 rng(dev());
+
+    // Shuffle around which number is which
+    int options[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::shuffle(std::begin(options) + 1, std::end(options), rng); // don't shuffle 0
+    for (int i = 0; i < 81; ++i)
+        _board[i / 9][i % 9] = options[seed[i / 9][i % 9]];
+
+    // Rotate and reflect the board
+    std::uniform_int_distribution<> dist(0, 3);
+    rotate(dist(rng));
+    reflect(dist(rng));
+
+    // Fix it to complete the function
+    fix();
+}
+
+Board Board::generateSeed(Progress *progress) {
+    Trace::Span span("Board::generateSeed");
+
+    Board board;
+    board.track(progress);
+
+    // Create a list of pointers to individual elements of the board
+    int shuffledBoard[81] = {};
+    for (int i = 0; i < 9; ++i)
+        for (int j = 0; j < 9; ++j)
+            shuffledBoard[i * 9 + j] = i * 9 + j; 
+
+    // Randomly shuffle that list of pointers
+    std::random_device rd;
+    std::mt19937 g(rd());
+    std::shuffle(std::begin(shuffledBoard), std::end(shuffledBoard), g);
+
+    // Create a list of options to move to randomly shuffle
+    int options[9] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+    // Iterate through all cells
+    for (int i = 0; i < 81; ++i) {
+        // Shuffle the list of options
+        std::shuffle(std::begin(options), std::end(options), g);
+
+        // Iterate through all the options for the selected element
+        for (int k = 0; k < 9; ++k) {
+            // If you can move to the current cell with the kth option to move, do so 
+            if (board.canMove(shuffledBoard[i] / 9, shuffledBoard[i] % 9, options[k])) {
+                board._board[shuffledBoard[i] / 9][shuffledBoard[i] % 9] = options[k];
+                
+                // Get the number of solutions remaining
+                int numSolutions = board.unique();
+                
+                if (numSolutions == 1) { // Return if 1 and only 1 solution
+                    board.fix();
+                    return board;
+                } else if (numSolutions > 1) { // If there is more than one, continue
+                    break;
+                } else { // If there are less than one, we messed up
+                    board._board[shuffledBoard[i] / 9][shuffledBoard[i] % 9] = 0; 
+                }
+            }
+        }
+    }
+
+    // Fix the board and return
+    board.fix();
+    return board; 
+}
+
+std::ostream& operator<<(std::ostream& os, const Board& board) {
+    for (int i = 0; i < 9; ++i)
+        for (int j = 0; j < 9; ++j)
+            os << board._board[i][j];
+
+    return os;
+}
@@ -0,0 +1,169 @@
+#ifndef SUDOKU_BOARD_HPP
+#define SUDOKU_BOARD_HPP
+
+// All code from the namespace `std` is part of the C++ standard library
+// made publically available by an ISO working group
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Shared between a running search and whoever is watching it from another thread
+struct Progress {
+    std::atomic<long> nodes = 0; // The number of cells the search has tried so far
+    std::atomic<bool> abort = false; // Set to make the search give up as soon as possible
+};
+
+// How hard a board is for a person to solve, by the hardest technique it needs (see rater.hpp)
+enum Difficulty { Easy, Medium, Hard, Expert, Extreme, Any };
+
+// One change to one cell, enough to undo or redo it without copying the board (see history.hpp)
+struct Move {
+    std::uint8_t cell; // The cell as row * 9 + column
+    std::uint8_t before; // The number the cell held before the move (0 if empty)
+    std::uint8_t after; // The number the cell holds after the move (0 if empty)
+    bool joined = false; // Undone and redone together with the move before it
+};
+
+class SeedIndex;
+
+// Define the Board and related methods for solving, testing unique, etc.
+class Board {
+    private:
+        int _board[9][9] = {}; // The board itself represented as a 2d Array
+        int *_fixed = new int[0]; // A list of indexes to the uneditable elements of the array
+        int _numFixed = 0; // The number of fixed elements (the sized of _fixed)
+        Progress *_progress = nullptr; // Where searches report to (not copied with the board)
+
+        // Count a search node; returns true if the search should give up
+        bool step() {
+            if (!_progress)
+                return false;
+
+            _progress->nodes.fetch_add(1, std::memory_order_relaxed);
+            return _progress->abort.load(std::memory_order_relaxed);
+        }
+
+        // Returns true if the board has any solution, given masks of the numbers already used in
+        // each row, column, and group. Always fills the most constrained cell first
+        bool solvable(std::uint16_t rows[9], std::uint16_t cols[9], std::uint16_t groups[9]);
+    
+    public:
+        // Default: do nothing
+        Board() {}
+        
+        // Copy constructor: necessary to prevent double free of _fixed
+        Board(const Board &copy);
+
+        // Assignment operator (similar to copy constructor except assigns an existing Board)
+        Board& operator=(const Board& copy);
+
+        // Construct a board from the first puzzle in some text (deserialize it), in any format
+        // `PuzzleReader` understands. The board is left empty if there isn't one
+        Board(std::string_view serialized);
+
+        // Delete _fixed so we don't leak memory
+        ~Board();
+
+        // Reset the board
+        void clear();
+
+        // Report the progress of `solve()`, `unique()`, and `generate()` to `progress`
+        // Pass nullptr to stop reporting
+        void track(Progress *progress) {
+            _progress = progress;
+        }
+
+        // Overload operator[] to allow for easy indexing of the array 
+        // Returns a constant: you must modify the board via `play()`
+        const int* operator[](const unsigned int r) const {
+            return _board[r];
+        }
+
+        // Set a cell to the number after/before a move, without any checks
+        void apply(const Move &move) {
+            _board[move.cell / 9][move.cell % 9] = move.after;
+        }
+        void revert(const Move &move) {
+            _board[move.cell / 9][move.cell % 9] = move.before;
+        }
+
+        // Taking in a row and col, returns a boolean describing if that cell is fixed
+        bool fixed(int r, int c) const;
+
+        // Fix the board as it is (prevent editing of non-zero elements in the future)
+        bool fix();
+
+        // Play a move if it's not overlapping a fixed piece 
+        bool play(int r, int c, int num);
+
+        // retun true if the number of non-zero numbers is 81 (a full board)
+        bool full() const;
+
+        // Count the number of non-zero numbers in the board
+        int count() const;
+
+        // Rotate a board 0, 1, 2, or 3 times
+        void rotate(int times);
+
+        // Reflect across axis 0, 1, 2, or 3 (no reflection, y-axis, x-axis, both)
+        void reflect(int axis);
+
+        // Validate a board by checking if any numbers repeat per row, column, and group
+        bool validate() const;
+
+        // Check more efficiently if moving to a specific row and column is valid
+        bool canMove(int r, int c, int num);
+
+        // Recursively solve via smart backtracking using a row and column to solve from
+        bool solve(int row, int col);
+
+        // Wrap the underlying solve function to only solve valid boards
+        bool solve();
+
+        // Recursively count the solutions from a row and column, on top of `num` already found
+        int unique(int row, int col, int num);
+
+        // Returns the number of solutions by recursively finding them
+        // Returns 0, 1, or 2 (2 simply means there are at least 2 solutions)
+        int unique();
+
+        // Remove every clue that isn't needed for the board to have exactly one solution
+        // Returns false (leaving the board alone) if it doesn't have exactly one solution
+        bool minimize();
+
+        // Read every seed in the seeds file into memory, skipping malformed ones
+        static std::vector<Board> loadSeeds(std::string file);
+
+        // Generate a new board of a difficulty (or Any) using the seeds file
+        // Loads its index every call, so use a SeedIndex (below) to generate more than one board
+        // Returns false (leaving the board empty) if there isn't one (see below)
+        bool generate(std::string file, Difficulty difficulty = Difficulty::Any);
+
+        // Generate a new board of a difficulty (or Any) using an already loaded seed index
+        // If there are no seeds of that difficulty, up to `attempts` new seeds are generated until
+        // one matches, which is appended to the seeds file so the next board comes from there
+        // Returns false (leaving the board empty) if none matched
+        bool generate(SeedIndex &index, Difficulty difficulty = Difficulty::Any, int attempts = 5);
+
+        // Generate a new board using seeds that have already been loaded
+        void generate(const std::vector<Board> &seeds);
+
+        // Generate a new board by shuffling the numbers of a seed and rotating/reflecting it
+        void generateFrom(const Board &seed);
+
+        // Static method to generate a seed for a puzzle (generates a board) 
+        // Optionally reports to `progress` while it searches
+        static Board generateSeed(Progress *progress = nullptr);
+
+        // Serialize the board using handy operator<< notation
+        // Simply put every element one after another with no spacing or formatting
+        friend std::ostream& operator<<(std::ostream& os, const Board& board);
+
+        // Parses puzzles straight into `_board`
+        friend class PuzzleReader;
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef SUDOKU_FILELOCK_HPP
+#define SUDOKU_FILELOCK_HPP
+
+// All code from the namespace `std` is part of the C++ standard library
+// made publically available by an ISO working group
+#include <string>
+
+// POSIX APIs for advisory file locks
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+// Holds an exclusive lock on a lock file (created if needed) for as long as it exists
+// Processes sharing a seeds file lock `<seeds>.lock` before writing to it or its index
+class FileLock {
+    private:
+        int _fd; // The lock file (-1 if it couldn't be opened, in which case nothing is locked)
+
+    public:
+        // Wait until the lock is free, then take it
+        FileLock(const std::string &path) : _fd(open(path.c_str(), O_RDWR | O_CREAT, 0644)) {
+            if (_fd >= 0)
+                flock(_fd, LOCK_EX);
+        }
+
+        // Release the lock
+        ~FileLock() {
+            if (_fd >= 0) {
+                flock(_fd, LOCK_UN);
+                close(_fd);
+            }
+        }
+
+        // Only one owner per lock
+        FileLock(const FileLock &copy) = delete;
+        FileLock& operator=(const FileLock &copy) = delete;
+};
+
+#endif
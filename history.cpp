@@ -0,0 +1,103 @@
+// All code from the namespace `std` is part of the C++ standard library
+// made publically available by an ISO working group
+#include <fstream>
+#include <utility>
+
+#include "history.hpp"
+
+void History::reset(const Board &start) {
+    _start = start;
+    _moves.clear(); // Keeps the capacity, so a new session doesn't allocate again
+    _applied = 0;
+}
+
+void History::record(Move move) {
+    // Nothing before the first move to join it to
+    if (_applied == 0)
+        move.joined = false;
+
+    // Drop the undone moves (trivially destructible, so this only moves the end)
+    _moves.resize(_applied);
+    _moves.push_back(move);
+    ++_applied;
+}
+
+bool History::undo(Board &board) {
+    if (_applied == 0)
+        return false;
+
+    // Revert back to the first move of the group (which is never joined)
+    do {
+        --_applied;
+        board.revert(_moves[_applied]);
+    } while (_moves[_applied].joined);
+
+    return true;
+}
+
+bool History::redo(Board &board) {
+    if (_applied == _moves.size())
+        return false;
+
+    // Apply the next move and every move joined to it
+    do {
+        board.apply(_moves[_applied]);
+        ++_applied;
+    } while (_applied < _moves.size() && _moves[_applied].joined);
+
+    return true;
+}
+
+void History::replay(Board &board, std::size_t moves) const {
+    board = _start;
+    for (std::size_t i = 0; i < moves && i < _moves.size(); ++i)
+        board.apply(_moves[i]);
+}
+
+bool History::save(const std::string &file) const {
+    std::ofstream out(file, std::ios::out | std::ios::trunc);
+
+    out << _start << '\n' << _applied << '\n';
+    for (const Move &move : _moves)
+        out << (int) move.cell << ' ' << (int) move.before << ' ' << (int) move.after << ' '
+            << move.joined << '\n';
+
+    return (bool) out;
+}
+
+bool History::load(const std::string &file, Board &board) {
+    std::ifstream in(file, std::ios::in);
+
+    std::string start;
+    std::size_t applied;
+    if (!(in >> start >> applied) || start.size() != 81 ||
+        start.find_first_not_of("0123456789") != std::string::npos)
+        return false;
+
+    // The filled cells of the starting board were fixed when the session started
+    Board first(start);
+    if (!first.fix())
+        return false;
+
+    std::vector<Move> moves;
+    int cell, before, after;
+    bool joined;
+    while (in >> cell >> before >> after >> joined) {
+        if (cell < 0 || cell > 80 || before < 0 || before > 9 || after < 0 || after > 9 ||
+            first.fixed(cell / 9, cell % 9))
+            return false;
+
+        moves.push_back(Move { (std::uint8_t) cell, (std::uint8_t) before, (std::uint8_t) after,
+                               joined && !moves.empty() });
+    }
+
+    // Stopping partway through a move made of several cells isn't possible
+    if (!in.eof() || applied > moves.size() || (applied < moves.size() && moves[applied].joined))
+        return false;
+
+    _start = first;
+    _moves = std::move(moves);
+    _applied = applied;
+    replay(board, _applied);
+    return true;
+}
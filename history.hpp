@@ -0,0 +1,59 @@
+#ifndef SUDOKU_HISTORY_HPP
+#define SUDOKU_HISTORY_HPP
+
+// All code from the namespace `std` is part of the C++ standard library
+// made publically available by an ISO working group
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "board.hpp"
+
+// The moves played on a board since it was started, for undo, redo, and replaying a session
+// Only the changed cells are kept (4 bytes per move), so undoing and redoing never copy the
+// board: moves are applied and reverted in place. The moves past `applied()` are the ones that
+// were undone, and are forgotten once a new move is recorded.
+//
+// Sessions are saved as text: the starting board, the number of applied moves, and then one
+// line per move, `<cell> <before> <after> <joined>`
+class History {
+    private:
+        Board _start; // The board the moves start from (its filled cells are all fixed)
+        std::vector<Move> _moves; // Every move, including any that were undone
+        std::size_t _applied = 0; // How many of `_moves` are on the board
+
+    public:
+        // Forget every move and start over from a board
+        void reset(const Board &start);
+
+        // Record a move that was just played, forgetting any undone moves
+        // Moves made of several cells (e.g. solving the board) record every cell but the first
+        // as joined
+        void record(Move move);
+
+        // Take back the last applied move (with any joined to it); returns false if there isn't one
+        bool undo(Board &board);
+
+        // Play the next undone move (with any joined to it); returns false if there isn't one
+        bool redo(Board &board);
+
+        // Set `board` to the starting board with the first `moves` moves played
+        void replay(Board &board, std::size_t moves) const;
+
+        // The number of moves recorded and the number of them on the board
+        std::size_t size() const {
+            return _moves.size();
+        }
+        std::size_t applied() const {
+            return _applied;
+        }
+
+        // Write the session to a file; returns false if it can't be written
+        bool save(const std::string &file) const;
+
+        // Read a session from a file and set `board` to where it left off
+        // Returns false (leaving everything alone) if the file is missing or malformed
+        bool load(const std::string &file, Board &board);
+};
+
+#endif
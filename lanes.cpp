@@ -0,0 +1,108 @@
+#include "lanes.hpp"
+#include "trace.hpp"
+#include "units.hpp"
+
+Lanes::Lanes(std::span<const Board> boards) {
+    Trace::Span span("Lanes::Lanes", boards.size());
+
+    for (std::size_t lane = 0; lane < boards.size() && lane < width; ++lane) {
+        std::uint32_t bit = 1u << lane;
+        _lanes |= bit;
+
+        // A filled cell can only hold its number; an empty one can hold any
+        for (int cell = 0; cell < 81; ++cell) {
+            int num = boards[lane][cell / 9][cell % 9];
+
+            if (num > 0 && num < 10)
+                _candidates[cell][num - 1] |= bit;
+            else
+                for (int n = 0; n < 9; ++n)
+                    _candidates[cell][n] |= bit;
+        }
+    }
+
+    while ((_failed & _lanes) != _lanes && propagate()) {}
+
+    // Solved lanes are down to one number in every cell
+    _solved = _lanes & ~_failed;
+    for (int cell = 0; cell < 81; ++cell)
+        _solved &= _placed[cell];
+}
+
+bool Lanes::propagate() {
+    bool changed = false;
+
+    // Naked singles: remove the number of every cell with one left from its peers
+    for (int cell = 0; cell < 81; ++cell) {
+        // Count the candidates of every lane at once: `once` has the lanes with at least one,
+        // `twice` the lanes with at least two
+        std::uint32_t once = 0;
+        std::uint32_t twice = 0;
+        for (std::uint32_t mask : _candidates[cell]) {
+            twice |= once & mask;
+            once |= mask;
+        }
+
+        _failed |= _lanes & ~once; // Nothing fits this cell
+        std::uint32_t single = once & ~twice & ~_placed[cell];
+        if (!single)
+            continue;
+
+        _placed[cell] |= single;
+        for (int n = 0; n < 9; ++n) {
+            std::uint32_t lanes = single & _candidates[cell][n];
+            if (!lanes)
+                continue;
+
+            for (int peer : unitTables.peers[cell]) {
+                changed |= (_candidates[peer][n] & lanes) != 0;
+                _candidates[peer][n] &= ~lanes;
+            }
+        }
+    }
+
+    // Hidden singles: a number with one cell left in a unit can only go there
+    for (const auto &unit : unitTables.units) {
+        for (int n = 0; n < 9; ++n) {
+            std::uint32_t once = 0;
+            std::uint32_t twice = 0;
+            for (int cell : unit) {
+                twice |= once & _candidates[cell][n];
+                once |= _candidates[cell][n];
+            }
+
+            _failed |= _lanes & ~once; // The number fits nowhere in this unit
+            std::uint32_t hidden = once & ~twice;
+            if (!hidden)
+                continue;
+
+            for (int cell : unit) {
+                std::uint32_t lanes = hidden & _candidates[cell][n];
+                if (!lanes)
+                    continue;
+
+                for (int other = 0; other < 9; ++other) {
+                    if (other != n) {
+                        changed |= (_candidates[cell][other] & lanes) != 0;
+                        _candidates[cell][other] &= ~lanes;
+                    }
+                }
+            }
+        }
+    }
+
+    return changed;
+}
+
+void Lanes::fill(std::size_t lane, Board &board) const {
+    std::uint32_t bit = 1u << lane;
+
+    for (int cell = 0; cell < 81; ++cell) {
+        if (!(_placed[cell] & bit) || board[cell / 9][cell % 9] > 0)
+            continue;
+
+        for (int n = 0; n < 9; ++n)
+            if (_candidates[cell][n] & bit)
+                board.play(cell / 9, cell % 9, n + 1);
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef SUDOKU_LANES_HPP
+#define SUDOKU_LANES_HPP
+
+// All code from the namespace `std` is part of the C++ standard library
+// made publically available by an ISO working group
+#include <cstdint>
+#include <span>
+
+#include "board.hpp"
+
+// Propagates singles on up to 32 boards in lockstep. Every candidate is stored bit-sliced: one
+// mask per cell and number with bit L for board L (its "lane"), so each step is a handful of
+// bitwise operations covering every board at once, with no branching on any one board.
+// Boards propagation can't finish need a search (see `fill()`)
+class Lanes {
+    private:
+        std::uint32_t _candidates[81][9] = {}; // Bit L of [cell][n - 1]: lane L's cell can hold n
+        std::uint32_t _placed[81] = {}; // Lanes whose cell is down to one number already removed
+                                        // from its peers
+        std::uint32_t _lanes = 0; // The lanes in use
+        std::uint32_t _failed = 0; // Lanes with no solution
+        std::uint32_t _solved = 0; // Lanes solved by propagation alone
+
+        // One round of naked and hidden singles on every lane
+        // Returns true if any candidates were removed
+        bool propagate();
+
+    public:
+        // The most boards that fit in one Lanes
+        static constexpr std::size_t width = 32;
+
+        // Load the filled cells of the boards (at most `width`) and propagate until stuck
+        explicit Lanes(std::span<const Board> boards);
+
+        // The lanes (bit L for boards[L]) with no solution, including boards with repeated numbers
+        std::uint32_t failed() const {
+            return _failed;
+        }
+
+        // The lanes solved by propagation alone; since singles are forced, these boards have
+        // exactly one solution
+        std::uint32_t solved() const {
+            return _solved;
+        }
+
+        // Play every cell propagation filled in for a lane on its board, leaving the rest for a
+        // search. The board has the same solutions afterwards
+        void fill(std::size_t lane, Board &board) const;
+};
+
+#endif
@@ -2,10 +2,41 @@
 // made publically available by an ISO working group
 #include <iostream>
 #include <algorithm>
-#include <iterator>
 #include <random>
 #include <fstream>
 #include <string>
+#include <sstream>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <memory>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+
+// The engine itself (libsudoku)
+#include "board.hpp"
+#include "batch.hpp"
+#include "pregenerator.hpp"
+#include "rater.hpp"
+#include "seedindex.hpp"
+#include "appender.hpp"
+#include "history.hpp"
+#include "reader.hpp"
+#include "filelock.hpp"
+#include "trace.hpp"
+
+// POSIX APIs for the Unix-domain socket used by `--serve`
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <cerrno>
+#include <unistd.h>
 
 // Apple uses an older version of NCurses, so you must #define a macro to be 1 for support
 #ifdef __APPLE__
@@ -22,451 +53,222 @@
 
 // Makes colors and status more clear to reference (e.g. Colors::Bad is the same as 1)
 enum Colors { Bad = 1, Good = 2, Fixed = 3 };
-enum Status { UserInput, UserSolve, Generate, Solve, Solved, Error };
+enum Status { UserInput, UserSolve, Generate, Solve, Solved, Error, Hint, Aborted };
 
-// Define the Board and related methods for solving, testing unique, etc.
-class Board {
+// Class which represents the user interface with the board
+class Game {
     private:
-        int _board[9][9] = {}; // The board itself represented as a 2d Array
-        int *_fixed = new int[0]; // A list of indexes to the uneditable elements of the array
-        int _numFixed = 0; // The number of fixed elements (the sized of _fixed)
-    
-    public:
-        // Default: do nothing
-        Board() {}
-        
-        // Copy constructor: necessary to prevent double free of _fixed
-        Board(const Board &copy) : _numFixed(copy._numFixed) {
-            for (int i = 0; i < 9; ++i)
-                for (int j = 0; j < 9; ++j)
-                    _board[i][j] = copy[i][j];
-        
-            // create a new _fixed and copy the elements of the original into it
-            _fixed = new int[_numFixed]; 
-            for (int i = 0; i < _numFixed; ++i)
-                _fixed[i] = copy._fixed[i]; 
-        }
-
-        // Assignment operator (similar to copy constructor except assigns an existing Board)
-        Board& operator=(const Board& copy) {
-            _numFixed = copy._numFixed;
-            for (int i = 0; i < 9; ++i)
-                for (int j = 0; j < 9; ++j)
-                    _board[i][j] = copy[i][j];
-
-            // create a new _fixed and copy the elements of the original into it
-            delete[] _fixed;
-            _fixed = new int[_numFixed];
-            for (int i = 0; i < _numFixed; ++i)
-                _fixed[i] = copy._fixed[i];
-
-            return *this;
-        }
-
-        // Construct a board from a string (deserialize it)
-        Board(std::string serialized) {
-            for (int i = 0; i < 81; ++i)
-                _board[i / 9][i % 9] = serialized[i] - '0';
-        }
-
-        // Delete _fixed so we don't leak memory
-        ~Board() {
-            delete[] _fixed;
-        }
-
-        // Reset the board
-        void clear() {
-            delete[] _fixed;
-
-            _numFixed = 0;
-            _fixed = new int[_numFixed];
-
-            for (int i = 0; i < 9; ++i)
-                for (int j = 0; j < 9; ++j)
-                    _board[i][j] = 0;
-        }
-
-        // Overload operator[] to allow for easy indexing of the array 
-        // Returns a constant: you must modify the board via `play()`
-        const int* operator[](const unsigned int r) const {
-            return _board[r];
-        }
-
-        // Taking in a row and col, returns a boolean describing if that cell is fixed
-        bool fixed(int r, int c) {
-            if (std::find(_fixed, _fixed + _numFixed, r * 9 + c) != _fixed + _numFixed)
-                return true;
-
-            return false;
-        }
-
-        // Fix the board as it is (prevent editing of non-zero elements in the future)
-        bool fix() {
-            // Don't fix a board if it's not valid or has no solution
-            if (!validate() || unique() < 1)
-                return false;
+        SeedIndex _seeds; // The seeds, indexed once (MUST BE BEFORE `_pregenerated`, which uses it)
+        Difficulty _difficulty = Difficulty::Any; // The difficulty of generated boards
+        Board _board; // The board itself
+        int _status = Status::UserInput; // The current status of the game
+        Pregenerator _pregenerated; // Boards generated in the background for 'g'
+        History _history; // The moves played since the board was generated, fixed, or reset
+        std::string _session; // Where the game is saved on quit and loaded from (empty for none)
 
-            // Get rid of old _fixed
-            delete[] _fixed;
+        // Solving, generating, and hints run on `_worker` so the input loop stays responsive
+        std::thread _worker; // Runs the current task (joinable while a task is running)
+        std::atomic<bool> _done = false; // Set by the worker once the task has finished
+        Progress _progress; // Node count of the current task + flag to abort it
+        Board _work; // The board the task operates on (owned by the worker until `_done`)
+        int _solutions = 0; // The number of solutions the task found (for 'g' and 'h')
 
-            // Set _numFixed to the number of non-zero elements & create a new array
-            _numFixed = count();
-            _fixed = new int[_numFixed];
+        MEVENT _event; // Mouse Event handler
 
-            // loop through and add all of the elements to be fixed to _fixed
-            int index = 0;
-            for (int i = 0; i < 9; ++i) {
-                for (int j = 0; j < 9; ++j) {
-                    if (_board[i][j] != 0) {
-                        _fixed[index] = i * 9 + j;
-                        ++index;
-                    }
+        // Run the task for `status` on a copy of the board in the background
+        void start(int status) {
+            _status = status;
+            _work = _board;
+            _work.track(&_progress);
+            _progress.nodes = 0;
+            _progress.abort = false;
+            _done = false;
+
+            _worker = std::thread([this, status]() {
+                Trace::Span span("Game::task", status);
+
+                switch (status) {
+                    case Status::Generate:
+                        // An empty board (no solutions) if no board of the difficulty turned up
+                        _solutions = _work.generate(_seeds, _difficulty) ? _work.unique() : 0;
+                        break;
+                    case Status::Solve:
+                        _work.solve();
+                        break;
+                    case Status::Hint:
+                        // Leave the solution in `_work` if there is one
+                        _solutions = _work.unique();
+                        if (_solutions > 0) {
+                            _work.fix();
+                            _work.solve();
+                        }
+                        break;
                 }
-            }
-
-            return true;
-        }
 
-        // Play a move if it's not overlapping a fixed piece 
-        bool play(int r, int c, int num) {
-            if (fixed(r, c))
-                return false;
-                
-            _board[r][c] = num > 0 && num < 10 ? num : 0;
-
-            return canMove(r, c, num);
-        }
+                _done.store(true, std::memory_order_release);
+            });
 
-        // retun true if the number of non-zero numbers is 81 (a full board)
-        bool full() {
-            return count() == 81;
+            updateTUI();
         }
 
-        // Count the number of non-zero numbers in the board
-        int count() {
-            int count = 0;
+        // Play a move on the board and record it so it can be undone
+        // `joined` moves are undone along with the move before them
+        bool play(int r, int c, int num, bool joined = false) {
+            Move played = { (std::uint8_t) (r * 9 + c), (std::uint8_t) _board[r][c], 0, joined };
+            bool valid = _board.play(r, c, num);
 
-            for (int i = 0; i < 9; ++i)
-                for (int j = 0; j < 9; ++j)
-                    if (_board[i][j] > 0 && _board[i][j] < 10)
-                        ++count; 
+            // Fixed cells (and playing the same number again) don't change anything
+            played.after = _board[r][c];
+            if (played.after != played.before)
+                _history.record(played);
 
-            return count;
+            return valid;
         }
 
-        // Rotate a board 0, 1, 2, or 3 times
-        void rotate(int times) {
-            if (times == 0)
+        // Check on the running task: apply its result if it finished, otherwise show progress
+        void poll() {
+            if (!_worker.joinable())
                 return;
 
-            Board old = *this; // Calls copy constructor
-
-            switch (times) {
-                case 1: // 90 deg: (x, y) -> (y, -x)
-                    for (int i = 0; i < 9; ++i)
-                        for (int j = 0; j < 9; ++j)
-                            _board[i][j] = old[j][8 - i];
-                    break;
-                case 2: // 180 deg: (x, y) -> (-x, -y)
-                    for (int i = 0; i < 9; ++i)
-                        for (int j = 0; j < 9; ++j)
-                            _board[i][j] = old[8 - i][8 - j];
-                    break;
-                case 3: // 270 deg: (x, y) -> (-y, x)
-                    for (int i = 0; i < 9; ++i)
-                        for (int j = 0; j < 9; ++j)
-                            _board[i][j] = old[8 - j][i];
-                    break;
-            }
-        }
-
-        // Reflect across axis 0, 1, 2, or 3 (no reflection, y-axis, x-axis, both)
-        void reflect(int axis) {
-            if (axis == 0)
+            if (!_done.load(std::memory_order_acquire)) {
+                updateTUI();
                 return;
-
-            Board old = *this;
-
-            switch (axis) {
-                case 1:
-                    for (int i = 0; i < 9; ++i)
-                        for (int j = 0; j < 9; ++j)
-                            _board[i][j] = old[8 - i][j];
-                    break;
-                case 2:
-                    for (int i = 0; i < 9; ++i)
-                        for (int j = 0; j < 9; ++j)
-                            _board[i][j] = old[i][8 - j];
-                    break;
-                case 3:
-                    for (int i = 0; i < 9; ++i)
-                        for (int j = 0; j < 9; ++j)
-                            _board[i][j] = old[8 - i][8 - j];
-                    break;
             }
-        }
-
-        // Validate a board by checking if any numbers repeat per row, column, and group
-        bool validate() {
-            for (int i = 0; i < 9; ++i) {
-                int row[9]; 
-                int col[9];
-                int group[9];
-
-                std::copy(std::begin(_board[i]), std::end(_board[i]), std::begin(row));
 
-                for (int j = 0; j < 9; ++j) {
-                    col[j] = _board[j][i];
-                    group[j] = _board[(i / 3) * 3 + j / 3][(i % 3) * 3 + j % 3];
-                }
-
-                std::sort(std::begin(row), std::end(row));
-                std::sort(std::begin(col), std::end(col));
-                std::sort(std::begin(group), std::end(group));
-
-                for (int j = 1; j < 9; ++j)
-                    if ((row[j] != 0 && row[j] == row[j - 1]) ||
-                        (col[j] != 0 && col[j] == col[j - 1]) ||
-                        (group[j] != 0 && group[j] == group[j - 1]))
-                        return false;
-            } 
+            _worker.join();
+            Trace::Span span("Game::finish", _status);
 
-            return true;
-        }
-
-        // Check more efficiently if moving to a specific row and column is valid
-        bool canMove(int r, int c, int num) {
-            if (num == 0) // Can always change to 0
-                return true;
-
-            int row[9]; 
-            int col[9];
-            int group[9];
-
-            int oldVal = _board[r][c]; // To reset the board afterward
-            _board[r][c] = 0; // Clear current value bc it will be overridden
-
-            std::copy(std::begin(_board[r]), std::end(_board[r]), std::begin(row));
-
-            int g = ((r / 3) * 3 + c / 3);
-            for (int j = 0; j < 9; ++j) {
-                col[j] = _board[j][c];
-                group[j] = _board[(g / 3) * 3 + j / 3][(g % 3) * 3 + j % 3];
-            }
-
-            // Check if anything in the row, col, or group is equal to the given number
-            for (int j = 0; j < 9; ++j) {
-                if ((row[j] == num) ||
-                    (col[j] == num) ||
-                    (group[j] == num)) {
-                    _board[r][c] = oldVal;
-                    return false;
-                }
+            // Leave the board as it was if the task was aborted
+            if (_progress.abort) {
+                _status = Status::Aborted;
+                updateTUI();
+                return;
             }
 
-            _board[r][c] = oldVal;
-            return true;
-        }
-
-        // Recursively solve via smart backtracking using a row and column to solve from
-        bool solve(int row, int col) {
-            if (col > 8) {
-                // Return a solution if we are on the bottom right corner of the board
-                if (row == 8)
-                    return true;
+            switch (_status) {
+                case Status::Generate:
+                    _board = _work;
+                    _history.reset(_board);
 
-                // If out of bounds by going too far to the right, wrap around to the next row
-                ++row;
-                col = 0;
-            }
-            
-            // If there's already a number, jump to the next cell
-            if (_board[row][col] > 0)
-                return solve(row, col + 1);
+                    // if not exactly one unique solution, show an error
+                    if (_solutions == 1)
+                        _status = Status::UserInput;
+                    else
+                        _status = Status::Error;
 
-            // Iterate through all options for numbers
-            for (int i = 1; i < 10; ++i) {
-                // If a number works, set it, recurse `solve()`, and reset if no solution
-                if (canMove(row, col, i)) {
-                    _board[row][col] = i;
+                    updateTUI();
+                    move(0, 0);
+                    break;
+                case Status::Solve:
+                    { // Play the solution as one move, so it can be undone
+                        bool joined = false;
+                        for (int i = 0; i < 81; ++i) {
+                            if (_work[i / 9][i % 9] != _board[i / 9][i % 9]) {
+                                play(i / 9, i % 9, _work[i / 9][i % 9], joined);
+                                joined = true;
+                            }
+                        }
+                    }
 
-                    if (solve(row, col + 1))
-                        return true;
+                    // If board isn't solved, show an error
+                    if (_board.full() && _board.validate())
+                        _status = Status::Solved;
+                    else
+                        _status = Status::Error;
+                    updateTUI();
 
-                    _board[row][col] = 0;
-                }   
+                    break;
+                case Status::Hint:
+                    _status = Status::UserInput;
+                    hint();
+                    break;
             }
-
-            return false; // no solution
-        }
-
-        // Wrap the underlying solve function to only solve valid boards
-        bool solve() {
-            // Reset anything that isn't fixed
-            for (int i = 0; i < 9; ++i)
-                for (int j = 0; j < 9; ++j)
-                    if (_board[i][j] > 0 && !fixed(i, j))
-                        _board[i][j] = 0;
-
-            // Don't solve an impossible board
-            if (!validate())
-                return false;
-            if (full())
-                return true;
-
-            return solve(0, 0);
         }
 
-        // Returns the number of solutions by recursively finding them
-        // Returns 0, 1, or 2 (2 simply means there are at least 2 solutions)
-        int unique(int row = 0, int col = 0, int num = 0) {
-            if (col > 8) {
-                // If out of bounds on the bottom right corner, we found one more solution
-                if (row == 8)
-                    return num + 1;
-
-                // If out of bounds on the right, go to the next row
-                ++row;
-                col = 0;
-            }
-
-            // If we find a fixed element, skip it
-            if (_board[row][col] > 0)
-                return unique(row, col + 1, num);
+        // Play one cell of the solution the hint task left in `_work`
+        void hint() {
+            // If there's less than one unique solution, hint unsolvable
+            if (_solutions < 1) {
+                updateTUI();
+                int x = getcurx(stdscr), y = getcury(stdscr);
 
-            // Iterate through all options
-            for (int i = 1; i < 10; ++i) {
-                // If we find a valid move, go there and then check for unique solutions
-                if (canMove(row, col, i)) {
-                    _board[row][col] = i;
+                // Setup hint
+                attron(COLOR_PAIR(Colors::Fixed));
+                mvprintw(0, 50, "Hint: ");
+                attroff(COLOR_PAIR(Colors::Fixed));
 
-                    num = unique(row, col + 1, num);
+                attron(COLOR_PAIR(Colors::Bad));
+                mvprintw(0, 56, "NOT SOLVABLE");
+                attroff(COLOR_PAIR(Colors::Bad));
 
-                    _board[row][col] = 0;
-
-                    if (num > 1)
-                        return num;
-                }   
+                move(y, x);
+                return;
             }
 
-            return num; // Return however many we found
-        }
-
-        // Generate a new board using the seeds file
-        void generate(std::string file) {
-            std::ifstream binary_file(file, std::ios::in | std::ios::binary); // Open the file
-
-            // To generate better random numbers
+            // Get a random index of the board
             std::random_device dev;
             std::mt19937 rng(dev());
-
-            std::string line, result;
-
-            // If there are no seeds, generate a new seed
-            if (binary_file.peek() == std::ifstream::traits_type::eof()) {
-                *this = generateSeed();
-                return;
+            std::uniform_int_distribution<> dist(0, 80);
+
+            // Get the closest empty blank near the selected index
+            int index = dist(rng);
+            while (_board[index / 9][index % 9] != 0) {
+                if (index < 80)
+                    ++index;
+                else
+                    index = 0;
             }
 
-            // For each line randomly decide if it should be the result
-            // Randomly select a number from 0 to the line number
-            // If the num is less than 1, set the result to this line (ensures a result)
-            for(std::size_t i = 0; std::getline(binary_file, line); ++i) {
-                std::uniform_int_distribution<> dist(0, i);
-                if (dist(rng) < 1)
-                    result = line;
-            }
-
-            binary_file.close(); // Close file
+            // Play the index
+            play(index / 9, index % 9, _work[index / 9][index % 9]);
 
-            // Shuffle around which number is which
-            int options[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
-            std::shuffle(std::begin(options) + 1, std::end(options), rng); // don't shuffle 0
-            for (int i = 0; i < 81; ++i)
-                _board[i / 9][i % 9] = options[result[i] - '0'];
+            // If this is the last number, change status to be solved
+            if (_board.validate() && _board.full())
+                _status = Status::Solved;
+            updateTUI(); // Update board + status
 
-            // Rotate and reflect the board
-            std::uniform_int_distribution<> dist(0, 3);
-            rotate(dist(rng));
-            reflect(dist(rng));
+            // Print the hint in green
+            attron(COLOR_PAIR(Colors::Good));
+            mvprintw((index / 9) + ((index / 9) / 3),
+                     ((index % 9) + ((index % 9) / 3)) * 2, 
+                     "%i", _board[index / 9][index % 9]);
+            attroff(COLOR_PAIR(Colors::Good));
 
-            // Fix it to complete the function
-            fix();
-        }
-
-        // Static method to generate a seed for a puzzle (generates a board) 
-        static Board generateSeed() {     
-            Board board;
-
-            // Create a list of pointers to individual elements of the board
-            int shuffledBoard[81] = {};
-            for (int i = 0; i < 9; ++i)
-                for (int j = 0; j < 9; ++j)
-                    shuffledBoard[i * 9 + j] = i * 9 + j; 
-
-            // Randomly shuffle that list of pointers
-            std::random_device rd;
-            std::mt19937 g(rd());
-            std::shuffle(std::begin(shuffledBoard), std::end(shuffledBoard), g);
-
-            // Create a list of options to move to randomly shuffle
-            int options[9] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
-
-            // Iterate through all cells
-            for (int i = 0; i < 81; ++i) {
-                // Shuffle the list of options
-                std::shuffle(std::begin(options), std::end(options), g);
-
-                // Iterate through all the options for the selected element
-                for (int k = 0; k < 9; ++k) {
-                    // If you can move to the current cell with the kth option to move, do so 
-                    if (board.canMove(shuffledBoard[i] / 9, shuffledBoard[i] % 9, options[k])) {
-                        board._board[shuffledBoard[i] / 9][shuffledBoard[i] % 9] = options[k];
-                        
-                        // Get the number of solutions remaining
-                        int numSolutions = board.unique();
-                        
-                        if (numSolutions == 1) { // Return if 1 and only 1 solution
-                            board.fix();
-                            return board;
-                        } else if (numSolutions > 1) { // If there is more than one, continue
-                            break;
-                        } else { // If there are less than one, we messed up
-                            board._board[shuffledBoard[i] / 9][shuffledBoard[i] % 9] = 0; 
-                        }
-                    }
-                }
-            }
+            // Board is solvable
+            attron(COLOR_PAIR(Colors::Fixed));
+            mvprintw(0, 50, "Hint: ");
+            attroff(COLOR_PAIR(Colors::Fixed));
+            
+            attron(COLOR_PAIR(Colors::Good));
+            mvprintw(0, 56, "SOLVABLE");
+            attroff(COLOR_PAIR(Colors::Good));
 
-            // Fix the board and return
-            board.fix();
-            return board; 
+            // Move to the hint
+            move(getcury(stdscr), getcurx(stdscr) - 1);
         }
 
-        // Serialize the board using handy operator<< notation
-        // Simply put every element one after another with no spacing or formatting
-        friend std::ostream& operator<<(std::ostream& os, const Board& board) {
-            for (int i = 0; i < 9; ++i)
-                for (int j = 0; j < 9; ++j)
-                    os << board._board[i][j];
-
-            return os;
+        // Shorten a node count to fit in the status field (e.g. 1234567 -> 1234k)
+        static std::string nodes(long count) {
+            if (count < 10000)
+                return std::to_string(count);
+            if (count < 10000000)
+                return std::to_string(count / 1000) + "k";
+            return std::to_string(count / 1000000) + "M";
         }
-};
-
-// Class which represents the user interface with the board
-class Game {
-    private:
-        std::string _seeds = "seeds.dat"; // The file that the seeds are stored in
-        Board _board; // The board itself
-        int _status = Status::UserInput; // The current status of the game
-
-        MEVENT _event; // Mouse Event handler
 
     public:
         // Default constructor that sets the locale & initializes the terminal using ncurses:
         // allows mouse events, creates the colors, and initializes the display
-        Game(std::string seeds = "seeds.dat") : _seeds(seeds) {
+        // Picks up the session saved in `session` if there is one
+        Game(std::string seeds = "seeds.dat", Difficulty difficulty = Difficulty::Any,
+             std::string session = "")
+            : _seeds(seeds), _difficulty(difficulty), _pregenerated(_seeds, difficulty),
+              _session(session) {
+            if (_session.empty() || !_history.load(_session, _board))
+                _history.reset(_board);
+            if (_board.validate() && _board.full())
+                _status = Status::Solved;
+
             // Necessary for support of wide characters (MUST BE BEFORE `initscr()`)
             setlocale(LC_ALL, "");
             setlocale(LC_NUMERIC,"C");
@@ -475,7 +277,7 @@ class Game {
             initscr();
             keypad(stdscr, TRUE); // Take input from special keys
             noecho(); // Don't display input on screen by default 
-            cbreak(); // Don't buffer lines; make input immediately available
+            halfdelay(1); // Don't buffer lines, and stop waiting for input after 0.1s
 
             // Capture mouse events
             mousemask(ALL_MOUSE_EVENTS, NULL);
@@ -494,8 +296,15 @@ class Game {
             move(0, 0);
         }
 
-        // Safely exit ncurses
+        // Abort any running task, save the session, and safely exit ncurses
         ~Game() {
+            _progress.abort = true;
+            if (_worker.joinable())
+                _worker.join();
+
+            if (!_session.empty())
+                _history.save(_session);
+
             endwin();
         }
 
@@ -506,6 +315,8 @@ class Game {
 
         // Update the information provided to the user
         void updateTUI() {
+            Trace::Span span("Game::updateTUI");
+
             int x = getcurx(stdscr), y = getcury(stdscr); // to reset the cursor later
 
             // Clear any currently available hints
@@ -520,10 +331,18 @@ class Game {
                     mvprintw(0, 34, "%s", "User Solving      ");
                     break;
                 case Status::Generate:
-                    mvprintw(0, 34, "%s", "Generating...     ");
+                    mvprintw(0, 34, "%-18s", ("Generating " + nodes(_progress.nodes)).c_str());
                     break;
                 case Status::Solve:
-                    mvprintw(0, 34, "%s", "Solving...        ");
+                    mvprintw(0, 34, "%-18s", ("Solving " + nodes(_progress.nodes)).c_str());
+                    break;
+                case Status::Hint:
+                    mvprintw(0, 34, "%-18s", ("Finding hint " + nodes(_progress.nodes)).c_str());
+                    break;
+                case Status::Aborted:
+                    attron(COLOR_PAIR(Colors::Bad));
+                    mvprintw(0, 34, "%s", "ABORTED           ");
+                    attroff(COLOR_PAIR(Colors::Bad));
                     break;
                 case Status::Solved:
                     attron(COLOR_PAIR(Colors::Good));
@@ -578,6 +397,8 @@ class Game {
             mvprintw(7, 30, "Solve: ");
             mvprintw(8, 30, "Hint: ");
             mvprintw(9, 30, "Reset: ");
+            mvprintw(10, 30, "Abort: ");
+            mvprintw(11, 30, "Undo | Redo: ");
             attroff(COLOR_PAIR(Colors::Fixed));
 
             // Actual keybinds themselves
@@ -588,6 +409,8 @@ class Game {
             mvprintw(7, 37, "S");
             mvprintw(8, 36, "H");
             mvprintw(9, 37, "R");
+            mvprintw(10, 37, "A");
+            mvprintw(11, 43, "U | Y");
 
             // Grid
             for (int i = 1; i < 12; ++i) {
@@ -607,6 +430,21 @@ class Game {
         // Base game loop that gets input from the user and performs a task based on it
         void loop() {
             for (int ch = getch(); ch != 'q'; ch = getch()) { // Until you type 'q', getch()
+                Trace::Span span(ch != ERR ? "Game::keystroke" : nullptr, ch);
+
+                // getch() gives up every 0.1s (ERR), so check on any running task
+                poll();
+
+                // While a task is running, only allow moving around and aborting
+                if (_worker.joinable()) {
+                    if (ch == 'a')
+                        _progress.abort = true;
+
+                    if (ch != KEY_MOUSE && ch != KEY_UP && ch != KEY_RIGHT &&
+                        ch != KEY_DOWN && ch != KEY_LEFT)
+                        continue;
+                }
+
                 switch (ch) {
                     case KEY_MOUSE:
                         if (getmouse(&_event) != OK)
@@ -664,113 +502,50 @@ class Game {
                         if (!_board.fix())
                             break;
 
-                        // Set status + update
+                        // Set status + update (undo stops at the fixed board)
+                        _history.reset(_board);
                         _status = Status::UserInput;
                         updateTUI();
                         break;
                     case 'g': // Generate board
-                        _status = Status::Generate;
-                        updateTUI();
-
-                        _board.generate(_seeds);
-
-                        // if not exactly one unique solution, show an error
-                        if (_board.unique() == 1)
+                        // Boards from the ring are already verified, so use one if available
+                        if (_pregenerated.pop(_board)) {
+                            _history.reset(_board);
                             _status = Status::UserInput;
-                        else
-                            _status = Status::Error;
+                            updateTUI();
+                            move(0, 0);
+                            break;
+                        }
 
-                        updateTUI();
-                        move(0, 0);
+                        // Otherwise generate one on the spot
+                        start(Status::Generate);
                         break;
                     case 's': // solve
-                        _status = Status::Solve;
-                        updateTUI();
-
-                        _board.solve();
-
-                        // If board isn't solved, show an error
-                        if (_board.full() && _board.validate())
-                            _status = Status::Solved;
-                        else
-                            _status = Status::Error;
-                        updateTUI();
-
+                        start(Status::Solve);
                         break;
                     case 'h': // hint
                         if (_status == Status::Solved)
                             break;
 
-                        { // Same thing; create new scope for variable initialization
-                            int x = getcurx(stdscr), y = getcury(stdscr);
-
-                            // If there's less than one unique solution, hint unsolvable
-                            if (_board.unique() < 1) {
-                                // Setup hint
-                                attron(COLOR_PAIR(Colors::Fixed));
-                                mvprintw(0, 50, "Hint: ");
-                                attroff(COLOR_PAIR(Colors::Fixed));
-
-                                attron(COLOR_PAIR(Colors::Bad));
-                                mvprintw(0, 56, "NOT SOLVABLE");
-                                attroff(COLOR_PAIR(Colors::Bad));
-
-                                move(y, x);
-                                break;
-                            }
-
-                            // Find the solution
-                            Board solution = _board;
-                            solution.fix();
-                            solution.solve();
-
-                            // Get a random index of the board
-                            std::random_device dev;
-                            std::mt19937 rng(dev());
-                            std::uniform_int_distribution<> dist(0, 80);
-
-                            // Get the closest empty blank near the selected index
-                            int index = dist(rng);
-                            while (_board[index / 9][index % 9] != 0) {
-                                if (index < 80)
-                                    ++index;
-                                else
-                                    index = 0;
-                            }
-
-                            // Play the index
-                            _board.play(index / 9, index % 9, solution[index / 9][index % 9]);
-
-                            // If this is the last number, change status to be solved
-                            if (_board.validate() && _board.full())
-                                _status = Status::Solved;
-                            updateTUI(); // Update board + status
-
-                            // Print the hint in green
-                            attron(COLOR_PAIR(Colors::Good));
-                            mvprintw((index / 9) + ((index / 9) / 3),
-                                     ((index % 9) + ((index % 9) / 3)) * 2, 
-                                     "%i", _board[index / 9][index % 9]);
-                            attroff(COLOR_PAIR(Colors::Good));
-
-                            // Board is solvable
-                            attron(COLOR_PAIR(Colors::Fixed));
-                            mvprintw(0, 50, "Hint: ");
-                            attroff(COLOR_PAIR(Colors::Fixed));
-                            
-                            attron(COLOR_PAIR(Colors::Good));
-                            mvprintw(0, 56, "SOLVABLE");
-                            attroff(COLOR_PAIR(Colors::Good));
-
-                            // Move to the hint
-                            move(getcury(stdscr), getcurx(stdscr) - 1);
-                        }
+                        start(Status::Hint);
                         break;
                     case 'r': // Reset board
                         _board.clear();
+                        _history.reset(_board);
                         _status = Status::UserInput;
                         updateTUI();
                         break;
+                    case 'u': // Undo
+                    case 'y': // Redo
+                        if (!(ch == 'u' ? _history.undo(_board) : _history.redo(_board)))
+                            break;
+
+                        if (_board.validate() && _board.full())
+                            _status = Status::Solved;
+                        else
+                            _status = Status::UserInput;
+                        updateTUI();
+                        break;
                     default: // Handle numbers
                         // If the input is a number or backspace, play the appropriate number
                         if (ch == 127 || ch == KEY_BACKSPACE || ch == 8 ||
@@ -778,9 +553,9 @@ class Game {
                             int x = getcurx(stdscr), y = getcury(stdscr); // to move back
 
                             // Play the position
-                            _board.play(y - (y / 4),
-                                       (x / 2) - ((x / 2) / 4),
-                                       '0' <= ch && '9' >= ch ? ch - '0' : 0);
+                            play(y - (y / 4),
+                                 (x / 2) - ((x / 2) / 4),
+                                 '0' <= ch && '9' >= ch ? ch - '0' : 0);
 
                             // Move the cursor to the next available spot in the same grid
                             if ((ch <= '9' && ch > '0' && 
@@ -833,9 +608,453 @@ class Game {
         }
 };
 
+// Answers requests over a Unix-domain socket (or stdin/stdout) without restarting the process
+// Every request is one line, `<op> [board]`, and gets one line back in the same order:
+//   `ok <microseconds> <result>` or `err <microseconds> <message>`
+// Supported ops (boards are 81 cells, 1-9 with 0 or . for blanks):
+//   solve <board>     -> the solved board
+//   count <board>     -> the number of solutions (0, 1, or 2 for "at least 2")
+//   validate <board>  -> 1 if no numbers repeat per row, column, and group, otherwise 0
+//   generate [difficulty] [clues]
+//                     -> a new board with exactly one solution, optionally of a difficulty
+//                        (easy, medium, hard, expert, extreme, or any) and number of clues
+//                        (an error if the seeds file has no seeds of that kind)
+//   hint <board>      -> `<row> <col> <num>` of one empty cell of the solution
+class Server {
+    private:
+        SeedIndex _seeds; // The seeds, indexed up front and kept up to date (shared by workers)
+        Pregenerator _pregenerated; // Boards of any difficulty generated in the background
+        std::mutex _popping; // `Pregenerator::pop()` only supports one consumer at a time
+
+        // A client, along with the start of a request it hasn't finished sending
+        struct Connection {
+            int fd; // The socket
+            std::string buffer; // Read but not yet answered (never a complete line)
+            bool open = true; // Cleared once the client goes away
+        };
+
+        // Connections are only handed to a worker once they have something to read, so idle
+        // clients never keep a worker from the others
+        std::queue<std::unique_ptr<Connection>> _readable; // Waiting for a worker to read them
+        std::mutex _waiting; // Guards `_readable`
+        std::condition_variable _arrived; // Signalled when a connection is queued
+        std::vector<std::unique_ptr<Connection>> _answered; // Handed back to `run()` by workers
+        std::mutex _returning; // Guards `_answered`
+        int _wake[2] = { -1, -1 }; // A pipe that wakes `run()` when a connection is handed back
+        std::atomic<bool> _bound = false; // Whether this server created the socket file
+
+        // Read a board out of a request; returns false if it isn't exactly one puzzle
+        static bool parse(const std::string &arg, Board &board) {
+            PuzzleReader reader(arg.data(), arg.size());
+            return reader.next(board) && reader.annotation().empty() && !reader.next(board) &&
+                   reader.errors().empty();
+        }
+
+        // Perform a single request, returning whether it succeeded and its result (or error)
+        bool perform(const std::string &op, const std::string &arg, const std::string &extra,
+                     std::string &result) {
+            Board board;
+
+            if (op == "generate") {
+                Difficulty difficulty = difficultyFromName(arg);
+                if (!arg.empty() && arg != "any" && difficulty == Difficulty::Any) {
+                    result = "unknown difficulty";
+                    return false;
+                }
+
+                int clues = 0;
+                if (!extra.empty()) {
+                    std::istringstream is(extra);
+                    if (!(is >> clues) || clues < 1 || clues > 81) {
+                        result = "malformed clues";
+                        return false;
+                    }
+                }
+
+                // Use a ready board if there is one (they are already verified)
+                bool verified = false;
+                if (clues == 0 && difficulty == Difficulty::Any) {
+                    std::lock_guard<std::mutex> lock(_popping);
+                    verified = _pregenerated.pop(board);
+                }
+
+                // Otherwise make one from the seeds, checking it like the pregenerator does (a
+                // seeds file may hold seeds without exactly one solution), trying a few seeds
+                for (int attempt = 0; !verified && attempt < 3; ++attempt) {
+                    if (clues > 0 || difficulty != Difficulty::Any) {
+                        // Only seeds of that difficulty (with exactly that many clues) will do:
+                        // new seeds rarely turn out to be a given difficulty, so none are made
+                        Board seed;
+                        if (!_seeds.pick(seed, difficulty, clues)) {
+                            result = clues > 0 ? "no seeds with that many clues" :
+                                                 "no seeds of that difficulty";
+                            return false;
+                        }
+                        board.generateFrom(seed);
+                    } else {
+                        board.generate(_seeds);
+                    }
+
+                    verified = board.unique() == 1;
+                }
+
+                if (!verified) {
+                    result = "no board with exactly one solution";
+                    return false;
+                }
+
+                std::ostringstream os;
+                os << board;
+                result = os.str();
+                return true;
+            }
+
+            if (op != "solve" && op != "count" && op != "validate" && op != "hint") {
+                result = "unknown op";
+                return false;
+            }
+
+            if (!parse(arg, board)) {
+                result = "malformed board";
+                return false;
+            }
+
+            if (op == "validate") {
+                result = board.validate() ? "1" : "0";
+                return true;
+            }
+
+            // A board with repeated numbers has no solutions
+            if (op == "count") {
+                result = std::to_string(board.validate() ? board.unique() : 0);
+                return true;
+            }
+
+            // Solve from the cells that are filled in (without resetting them like `solve()`)
+            Board solution = board;
+            if (!solution.validate() || !(solution.full() || solution.solve(0, 0))) {
+                result = "no solution";
+                return false;
+            }
+
+            if (op == "solve") {
+                std::ostringstream os;
+                os << solution;
+                result = os.str();
+                return true;
+            }
+
+            // Hint: the closest empty cell near a random index (same as the game)
+            if (board.full()) {
+                result = "board is full";
+                return false;
+            }
+
+            std::random_device dev;
+            std::mt19937 rng(dev());
+            std::uniform_int_distribution<> dist(0, 80);
+
+            int index = dist(rng);
+            while (board[index / 9][index % 9] != 0)
+                index = index < 80 ? index + 1 : 0;
+
+            result = std::to_string(index / 9) + " " + std::to_string(index % 9) + " " +
+                     std::to_string(solution[index / 9][index % 9]);
+            return true;
+        }
+
+        // Answer one request line, timing how long it took
+        std::string respond(const std::string &line) {
+            Trace::Span span("Server::request");
+            auto begin = std::chrono::steady_clock::now();
+
+            // Split the line into the op and its (optional) arguments
+            std::istringstream is(line);
+            std::string op, arg, extra, result;
+            is >> op >> arg >> extra;
+
+            bool ok = perform(op, arg, extra, result);
+
+            auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - begin);
+
+            return (ok ? "ok " : "err ") + std::to_string(elapsed.count()) + " " + result;
+        }
+
+        // Respond to every complete line in `buffer` (leaving the rest), writing the responses to
+        // `out`; returns false if the client went away
+        bool answer(std::string &buffer, int out) {
+            std::string responses;
+
+            std::size_t start = 0;
+            for (std::size_t end; (end = buffer.find('\n', start)) != std::string::npos;
+                 start = end + 1) {
+                std::string line = buffer.substr(start, end - start);
+                if (!line.empty() && line.back() == '\r')
+                    line.pop_back();
+                if (!line.empty())
+                    responses += respond(line) + "\n";
+            }
+            buffer.erase(0, start);
+
+            for (std::size_t written = 0; written < responses.size();) {
+                ssize_t w = write(out, responses.data() + written, responses.size() - written);
+                if (w <= 0)
+                    return false;
+                written += w;
+            }
+
+            return true;
+        }
+
+        // Serve every request from `in` until it closes, writing responses to `out`
+        // Requests may be pipelined: responses to everything read so far are written at once
+        void serve(int in, int out) {
+            std::string buffer;
+            char chunk[65536];
+
+            for (ssize_t n; (n = read(in, chunk, sizeof(chunk))) > 0;) {
+                buffer.append(chunk, n);
+                if (!answer(buffer, out))
+                    return;
+            }
+        }
+
+        // Answer whatever has arrived on queued connections, then hand them back to `run()` to
+        // wait for more, forever
+        void work() {
+            char chunk[65536];
+
+            while (true) {
+                std::unique_lock<std::mutex> lock(_waiting);
+                _arrived.wait(lock, [this]() { return !_readable.empty(); });
+                std::unique_ptr<Connection> connection = std::move(_readable.front());
+                _readable.pop();
+                lock.unlock();
+
+                // `run()` saw something to read (or the client leaving), so this doesn't block
+                ssize_t n = read(connection->fd, chunk, sizeof(chunk));
+                if (n > 0)
+                    connection->buffer.append(chunk, n);
+                connection->open = n > 0 && answer(connection->buffer, connection->fd);
+
+                std::lock_guard<std::mutex> returning(_returning);
+                _answered.push_back(std::move(connection));
+                char wake = 0;
+                if (write(_wake[1], &wake, 1) < 0)
+                    std::cerr << "could not wake the server" << std::endl;
+            }
+        }
+
+    public:
+        // Load the seeds and start generating boards in the background
+        Server(std::string seeds = "seeds.dat") : _seeds(seeds), _pregenerated(_seeds) {}
+
+        // Whether `run()` created the socket file (so it is this server's to remove)
+        bool bound() const {
+            return _bound;
+        }
+
+        // Serve requests on the Unix-domain socket at `path`, or on stdin/stdout if it is "-"
+        // Refuses to replace anything at `path` but a socket nothing is listening on
+        // Only returns on error (with a non-zero exit code)
+        int run(std::string path) {
+            // Don't die when a client disconnects before reading its responses
+            std::signal(SIGPIPE, SIG_IGN);
+
+            if (path == "-") {
+                serve(STDIN_FILENO, STDOUT_FILENO);
+                return 0;
+            }
+
+            sockaddr_un address = {};
+            address.sun_family = AF_UNIX;
+            if (path.size() >= sizeof(address.sun_path)) {
+                std::cerr << "socket path too long: " << path << std::endl;
+                return 1;
+            }
+            std::copy(path.begin(), path.end(), address.sun_path);
+
+            // Only replace a stale socket left behind by a previous server: never another kind
+            // of file, and never a socket that a running server still accepts connections on
+            struct stat info;
+            if (lstat(path.c_str(), &info) == 0) {
+                int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+                bool stale = probe >= 0 && S_ISSOCK(info.st_mode) &&
+                             connect(probe, (sockaddr *) &address, sizeof(address)) < 0 &&
+                             errno == ECONNREFUSED;
+                if (probe >= 0)
+                    close(probe);
+
+                if (!stale) {
+                    std::cerr << path << " is in use or isn't a socket" << std::endl;
+                    return 1;
+                }
+                unlink(path.c_str());
+            }
+
+            int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (listener < 0 || bind(listener, (sockaddr *) &address, sizeof(address)) < 0) {
+                std::cerr << "could not listen on " << path << std::endl;
+                return 1;
+            }
+            _bound = true;
+
+            if (listen(listener, SOMAXCONN) < 0 || pipe(_wake) < 0) {
+                std::cerr << "could not listen on " << path << std::endl;
+                return 1;
+            }
+
+            // One worker per core, each answering one connection at a time
+            unsigned int workers = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned int i = 0; i < workers; ++i)
+                std::thread(&Server::work, this).detach();
+
+            // Wait for new connections and for requests on the connections no worker has, and hand
+            // every connection with something to read to a worker
+            std::vector<std::unique_ptr<Connection>> idle;
+            std::vector<pollfd> fds;
+            while (true) {
+                // Take back the connections the workers are done with, closing the ones that left
+                {
+                    std::lock_guard<std::mutex> lock(_returning);
+                    for (std::unique_ptr<Connection> &connection : _answered) {
+                        if (connection->open)
+                            idle.push_back(std::move(connection));
+                        else
+                            close(connection->fd);
+                    }
+                    _answered.clear();
+                }
+
+                fds.clear();
+                fds.push_back({ listener, POLLIN, 0 });
+                fds.push_back({ _wake[0], POLLIN, 0 });
+                for (const std::unique_ptr<Connection> &connection : idle)
+                    fds.push_back({ connection->fd, POLLIN, 0 });
+
+                if (poll(fds.data(), fds.size(), -1) < 0)
+                    continue;
+
+                if (fds[1].revents) {
+                    char woken[256];
+                    if (read(_wake[0], woken, sizeof(woken)) < 0)
+                        continue;
+                }
+
+                // Backwards, so moving the last connection into a gap only moves one already seen
+                {
+                    std::lock_guard<std::mutex> lock(_waiting);
+                    for (std::size_t i = idle.size(); i-- > 0;) {
+                        if (!fds[i + 2].revents)
+                            continue;
+
+                        _readable.push(std::move(idle[i]));
+                        idle[i] = std::move(idle.back());
+                        idle.pop_back();
+                        _arrived.notify_one();
+                    }
+                }
+
+                if (fds[0].revents) {
+                    int connection = accept(listener, nullptr, nullptr);
+                    if (connection >= 0)
+                        idle.push_back(std::make_unique<Connection>(connection));
+                }
+            }
+        }
+};
+
+// Call `task(i)` for every i in [0, num) spread across one thread per core
+template <typename Task>
+void forEachParallel(std::size_t num, Task task) {
+    std::atomic<std::size_t> next = 0;
+    std::vector<std::thread> threads(std::max(1u, std::thread::hardware_concurrency()));
+
+    for (std::thread &thread : threads)
+        thread = std::thread([&]() {
+            for (std::size_t i = next++; i < num; i = next++)
+                task(i);
+        });
+
+    for (std::thread &thread : threads)
+        thread.join();
+}
+
+// Read every puzzle in a file, printing where any malformed lines are
+// `annotations[i]` is whatever followed boards[i] on its line (e.g. the rating written by -r)
+// `size` (if given) is set to how many bytes of the file were read
+// Returns false if any lines were malformed
+bool readPuzzles(std::string file, std::vector<Board> &boards,
+                 std::vector<std::string> &annotations, std::uint64_t *size = nullptr) {
+    PuzzleReader reader(file);
+    if (size)
+        *size = reader.size();
+
+    Board board;
+    while (reader.next(board)) {
+        boards.push_back(board);
+        annotations.emplace_back(reader.annotation());
+    }
+
+    for (const ParseError &error : reader.errors())
+        std::cout << file << ':' << error.offset << ": " << error.message << std::endl;
+
+    return reader.errors().empty();
+}
+
+// Replace the contents of a seeds file with `lines` and rebuild its index (the seeds moved)
+// `lines` come from the first `size` bytes of the file as it was in `original` (from stat());
+// seeds other processes appended since (e.g. with -g) are carried over as they are
+// Returns false if the file couldn't be written or was replaced since it was read
+bool rewriteSeeds(std::string file, const std::vector<std::string> &lines,
+                  const struct stat &original, std::uint64_t size) {
+    // Write to a temporary file of our own next to it, so concurrent rewrites don't collide
+    std::string temporary = file + ".XXXXXX";
+    int fd = mkstemp(temporary.data());
+    if (fd < 0)
+        return false;
+    fchmod(fd, original.st_mode & 0777);
+    close(fd);
+
+    std::ofstream binary_file(temporary, std::ios::out | std::ios::binary | std::ios::trunc);
+    for (const std::string &line : lines)
+        binary_file << line << '\n';
+
+    // Keep other processes from appending while the new seeds are copied and the file replaced
+    {
+        FileLock lock(file + ".lock");
+
+        struct stat current;
+        if (stat(file.c_str(), &current) != 0 || current.st_ino != original.st_ino ||
+            current.st_dev != original.st_dev) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+
+        std::ifstream appended(file, std::ios::in | std::ios::binary);
+        appended.seekg(size);
+        if (appended.peek() != std::ifstream::traits_type::eof())
+            binary_file << appended.rdbuf();
+        binary_file.close();
+
+        if (!binary_file || std::rename(temporary.c_str(), file.c_str()) != 0) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+
+        std::remove((file + ".idx").c_str());
+    }
+
+    SeedIndex index(file);
+    return true;
+}
+
 // Program insertion point
 int main(int argc, char **argv) {
     std::string seedsFile = "seeds.dat"; // default seeds file
+    Difficulty difficulty = Difficulty::Any; // default difficulty of generated boards
+    std::string sessionFile; // where the game is saved (none by default)
 
     // Get any command-line arguments if there are any
     if (argc > 1) {
@@ -846,21 +1065,92 @@ int main(int argc, char **argv) {
             std::cout << "  sudoku -h               | prints this screen" << std::endl;
             std::cout << "  sudoku -s [file]        | sets the source for seeds to be [file]";
             std::cout << " (seeds.dat by default)" << std::endl;
+            std::cout << "  sudoku -d [difficulty]  | only generates boards of [difficulty]:";
+            std::cout << " easy, medium, hard, expert, extreme (any by default)" << std::endl;
             std::cout << "  sudoku -g [num]         | generates [num] seeds for sudoku puzzl";
-            std::cout << "es (100 by default) and exports to seeds.dat" << std::endl;
-            std::cout << "  sudoku -t               | tests the seeds file for seeds with un";
-            std::cout << "ique solutions" << std::endl;
+            std::cout << "es (100 by default) and exports to seeds.dat, skipping duplicates";
+            std::cout << " (safe to run in parallel)" << std::endl;
+            std::cout << "  sudoku -t [file]        | tests each seed in [file] (the seeds f";
+            std::cout << "ile by default) has a unique solution; files may use . for blanks,";
+            std::cout << " # comments, and 9-line grids" << std::endl;
+            std::cout << "  sudoku -r [file]        | rates each seed in [file] (the seeds f";
+            std::cout << "ile by default) by the hardest technique it needs" << std::endl;
+            std::cout << "  sudoku -m [file]        | removes clues each seed in [file] (the";
+            std::cout << " seeds file by default) doesn't need to have one solution" << std::endl;
+            std::cout << "  sudoku --serve [socket] | answers solve/count/validate/generate/";
+            std::cout << "hint requests on [socket] (- for stdin/stdout)" << std::endl;
+            std::cout << "  sudoku --trace [file]   | records how long everything takes to [";
+            std::cout << "file] as Chrome trace events" << std::endl;
+            std::cout << "  sudoku --session [file] | saves the game to [file] on quit and";
+            std::cout << " picks it up from there next time (session.txt by default)" << std::endl;
             return 0;
         }
 
+        // Record a trace if requested (--trace); it is written when the program exits
+        char **trace = std::find(argv, argv + argc, std::string("--trace"));
+        if (trace != argv + argc) {
+            Trace::start((trace + 1) == argv + argc ? "trace.json" : *(trace + 1));
+            std::atexit(Trace::stop);
+        }
+
         // Set the seeds file if requested (-s)
         char **s = std::find(argv, argv + argc, std::string("-s"));
         if (s != argv + argc)
             seedsFile = *(s + 1);
 
+        // Set the difficulty if requested (-d)
+        char **d = std::find(argv, argv + argc, std::string("-d"));
+        if (d != argv + argc) {
+            std::string name = (d + 1) == argv + argc ? "" : *(d + 1);
+            difficulty = difficultyFromName(name);
+            if (name != "any" && difficulty == Difficulty::Any) {
+                std::cout << "unknown difficulty: " << name << std::endl;
+                return 1;
+            }
+        }
+
+        // Save and restore the game if requested (--session)
+        char **session = std::find(argv, argv + argc, std::string("--session"));
+        if (session != argv + argc)
+            sessionFile = (session + 1) == argv + argc ? "session.txt" : *(session + 1);
+
+        // Serve requests if requested (--serve)
+        char **serve = std::find(argv, argv + argc, std::string("--serve"));
+        if (serve != argv + argc) {
+            std::string path = (serve + 1) == argv + argc ? "-" : *(serve + 1);
+
+            // Block SIGINT/SIGTERM on every thread (so before starting any) and wait for them
+            // here, so stopping the server still writes the trace and removes the socket
+            sigset_t signals;
+            sigemptyset(&signals);
+            sigaddset(&signals, SIGINT);
+            sigaddset(&signals, SIGTERM);
+            pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+            Server server(seedsFile);
+            std::atomic<int> status = 0;
+            std::thread([&]() {
+                status = server.run(path);
+                kill(getpid(), SIGTERM); // Stop waiting if the server stops on its own
+            }).detach();
+
+            int signal;
+            sigwait(&signals, &signal);
+            if (server.bound())
+                unlink(path.c_str());
+
+            // The workers and the pregenerator may still be running (and using `server` and the
+            // trace's buffers), so write the trace and exit without destroying anything
+            Trace::stop();
+            std::cout.flush();
+            std::quick_exit(status);
+        }
+
         // Generate seeds for sudoku puzzles if requested (-g)
         char **g = std::find(argv, argv + argc, std::string("-g"));
         if (g != argv + argc) {
+            Trace::Span span("generate seeds");
+
             // Initialize screen
             setlocale(LC_ALL, "");
             initscr();
@@ -875,17 +1165,30 @@ int main(int argc, char **argv) {
             mvprintw(1, 0, "[                    ] (0/%i)", num);
             refresh();
 
-            // Open file for output
-            std::ofstream binary_file(seedsFile, 
-                                      std::ios::out | std::ios::binary | std::ios::app);
+            // Open file for output (safe to share with other processes generating seeds)
+            SeedAppender appender(seedsFile);
 
             // Generate the number of seeds requested
+            Rater rater;
             for (int i = 0; i < num; ++i) {
-                // Generate a board
-                Board board = Board::generateSeed();
+                // Generate a board, trying again until it is the requested difficulty and isn't
+                // already in the file
+                Board board;
+                Technique technique;
+                SeedAppender::Result appended = SeedAppender::Duplicate;
+                while (appended == SeedAppender::Duplicate) {
+                    board = Board::generateSeed();
+                    technique = rater.rate(board);
+                    if (difficulty == Difficulty::Any || difficultyOf(technique) == difficulty)
+                        appended = appender.append(board, techniqueName(technique));
+                }
 
-                // Add the serialized board to the file
-                binary_file << board << std::endl;
+                // Stop if the seeds can't be written at all (trying again won't help)
+                if (appended == SeedAppender::Failed) {
+                    endwin();
+                    std::cout << "could not write " << seedsFile << std::endl;
+                    return 1;
+                }
 
                 // Update the status on completing the number of seeds
                 for (int j = 0; j < ((20 * (i + 1)) / num); ++j)
@@ -894,8 +1197,8 @@ int main(int argc, char **argv) {
                 refresh();
             }
 
-            // Close the file and exit
-            binary_file.close();
+            // Index the new seeds and exit
+            SeedIndex index(seedsFile);
             endwin();
             return 0;
         }
@@ -903,28 +1206,136 @@ int main(int argc, char **argv) {
         // Test the generated seeds if requested (-t)
         char **t = std::find(argv, argv + argc, std::string("-t"));
         if (t != argv + argc) {
-            std::ifstream binary_file(*(t + 1), std::ios::in | std::ios::binary);
-
-            std::string line;
-            while (std::getline(binary_file, line)) {
-                Board board(line);
-                // If there isn't one unique solution to the puzzle, fail the test
-                if (board.unique() != 1) {
-                    binary_file.close();
-                    std::cout << "FAILED" << std::endl;
-                    return 1;
-                }
+            Trace::Span span("test seeds");
+
+            std::string file = (t + 1) == argv + argc ? seedsFile : *(t + 1);
+            std::vector<Board> boards;
+            std::vector<std::string> annotations;
+            bool parsed = readPuzzles(file, boards, annotations);
+            std::vector<int> counts(boards.size());
+
+            countAll(boards, counts);
+
+            // If any seed is malformed or doesn't have one unique solution, fail the test
+            if (!parsed || std::any_of(counts.begin(), counts.end(), [](int count) { return count != 1; })) {
+                std::cout << "FAILED" << std::endl;
+                return 1;
             }
 
             // If nothing fails, pass the test
-            binary_file.close();
             std::cout << "PASSED" << std::endl;
             return 0;
         }
+
+        // Rate the seeds if requested (-r)
+        char **r = std::find(argv, argv + argc, std::string("-r"));
+        if (r != argv + argc) {
+            Trace::Span span("rate seeds");
+
+            std::string file = (r + 1) == argv + argc ? seedsFile : *(r + 1);
+            std::vector<Board> boards;
+            std::vector<std::string> seeds;
+            std::uint64_t size;
+            struct stat original;
+            if (stat(file.c_str(), &original) != 0) {
+                std::cout << "could not read " << file << std::endl;
+                return 1;
+            }
+            if (!readPuzzles(file, boards, seeds, &size)) {
+                std::cout << "fix or remove the malformed seeds first" << std::endl;
+                return 1;
+            }
+            std::vector<Technique> ratings(boards.size());
+
+            // Rate every seed, with one Rater per thread
+            auto begin = std::chrono::steady_clock::now();
+            forEachParallel(boards.size(), [&](std::size_t i) {
+                thread_local Rater rater;
+                ratings[i] = rater.rate(boards[i]);
+            });
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+            // Rewrite the file with the rating after each seed (replacing any old rating)
+            for (std::size_t i = 0; i < boards.size(); ++i) {
+                std::ostringstream os;
+                os << boards[i] << ' ' << techniqueName(ratings[i]);
+                seeds[i] = os.str();
+            }
+
+            if (!rewriteSeeds(file, seeds, original, size)) {
+                std::cout << "could not write " << file << " (or it was replaced meanwhile)";
+                std::cout << std::endl;
+                return 1;
+            }
+
+            // Summarize
+            for (int i = 0; i <= Technique::Invalid; ++i) {
+                long num = std::count(ratings.begin(), ratings.end(), (Technique) i);
+                if (num > 0)
+                    std::cout << techniqueName((Technique) i) << ": " << num << std::endl;
+            }
+            std::cout << "rated " << seeds.size() << " seeds in " << elapsed.count() << "s";
+            std::cout << std::endl;
+            return 0;
+        }
+
+        // Minimize the seeds if requested (-m)
+        char **m = std::find(argv, argv + argc, std::string("-m"));
+        if (m != argv + argc) {
+            Trace::Span span("minimize seeds");
+
+            std::string file = (m + 1) == argv + argc ? seedsFile : *(m + 1);
+            std::vector<Board> boards;
+            std::vector<std::string> seeds;
+            std::uint64_t size;
+            struct stat original;
+            if (stat(file.c_str(), &original) != 0) {
+                std::cout << "could not read " << file << std::endl;
+                return 1;
+            }
+            if (!readPuzzles(file, boards, seeds, &size)) {
+                std::cout << "fix or remove the malformed seeds first" << std::endl;
+                return 1;
+            }
+            std::atomic<long> before = 0, after = 0, failed = 0;
+
+            // Minimize every seed, rating it again if it was rated before
+            auto begin = std::chrono::steady_clock::now();
+            forEachParallel(boards.size(), [&](std::size_t i) {
+                Board &board = boards[i];
+                before += board.count();
+
+                if (!board.minimize())
+                    ++failed;
+                after += board.count();
+
+                std::ostringstream os;
+                os << board;
+                if (!seeds[i].empty()) {
+                    thread_local Rater rater;
+                    os << ' ' << techniqueName(rater.rate(board));
+                }
+                seeds[i] = os.str();
+            });
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+            if (!rewriteSeeds(file, seeds, original, size)) {
+                std::cout << "could not write " << file << " (or it was replaced meanwhile)";
+                std::cout << std::endl;
+                return 1;
+            }
+
+            // Summarize
+            std::cout << "minimized " << seeds.size() << " seeds in " << elapsed.count() << "s: ";
+            std::cout << before << " -> " << after << " clues" << std::endl;
+            if (failed > 0)
+                std::cout << failed << " seeds without exactly one solution were left alone\n";
+            return 0;
+        }
     }
 
     // Initialize the game and loop
-    Game game(seedsFile);
+    Game game(seedsFile, difficulty, sessionFile);
     game.loop();
     
     return 0;
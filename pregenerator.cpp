@@ -0,0 +1,63 @@
+#include "pregenerator.hpp"
+#include "trace.hpp"
+
+Pregenerator::Pregenerator(SeedIndex &seeds, Difficulty difficulty) : _seeds(seeds),
+                                                                       _difficulty(difficulty),
+                                                                       _worker(&Pregenerator::work,
+                                                                               this) {}
+
+Pregenerator::~Pregenerator() {
+    _running = false;
+    _progress.abort = true;
+    _wake.fetch_add(1, std::memory_order_release);
+    _wake.notify_one();
+    _worker.join();
+}
+
+void Pregenerator::work() {
+    while (_running) {
+        // Read the wake counter before checking for space so no wakeup is lost
+        int wake = _wake.load(std::memory_order_acquire);
+        int tail = _tail.load(std::memory_order_relaxed);
+        int next = (tail + 1) % _capacity;
+
+        if (next == _head.load(std::memory_order_acquire)) {
+            _wake.wait(wake, std::memory_order_acquire);
+            continue;
+        }
+
+        // Only keep boards with exactly one solution
+        Trace::Span span("Pregenerator::generate");
+        Board board;
+        board.track(&_progress);
+        if (!board.generate(_seeds, _difficulty)) {
+            // No seeds of the difficulty turned up, so don't try again until a board is wanted
+            _wake.wait(wake, std::memory_order_acquire);
+            continue;
+        }
+        if (board.unique() != 1 || !_running)
+            continue;
+
+        // Publish the board to the consumer
+        _ring[tail] = board;
+        _tail.store(next, std::memory_order_release);
+    }
+}
+
+bool Pregenerator::pop(Board &board) {
+    int head = _head.load(std::memory_order_relaxed);
+    if (head == _tail.load(std::memory_order_acquire)) {
+        // Let the worker know a board is wanted, in case it gave up for lack of seeds
+        _wake.fetch_add(1, std::memory_order_release);
+        _wake.notify_one();
+        return false;
+    }
+
+    board = _ring[head];
+    _head.store((head + 1) % _capacity, std::memory_order_release);
+
+    // Let the worker know there is room again
+    _wake.fetch_add(1, std::memory_order_release);
+    _wake.notify_one();
+    return true;
+}
@@ -0,0 +1,46 @@
+#ifndef SUDOKU_PREGENERATOR_HPP
+#define SUDOKU_PREGENERATOR_HPP
+
+// All code from the namespace `std` is part of the C++ standard library
+// made publically available by an ISO working group
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "board.hpp"
+#include "seedindex.hpp"
+
+// Keeps a small ring buffer of generated and verified boards, refilled by a background thread
+// There is exactly one producer (the worker) and one consumer (`pop()`), so no locks are needed
+class Pregenerator {
+    private:
+        static const int _capacity = 4; // Size of the ring (one slot is always left empty)
+
+        SeedIndex &_seeds; // The seeds (owned by whoever owns the pregenerator)
+        Difficulty _difficulty; // The difficulty of the boards to generate
+        Board _ring[_capacity]; // The boards themselves
+        std::atomic<int> _head = 0; // Next slot to pop (only written by the consumer)
+        std::atomic<int> _tail = 0; // Next slot to fill (only written by the producer)
+        std::atomic<int> _wake = 0; // Bumped to wake the worker when a slot frees up or on exit
+        std::atomic<bool> _running = true; // Cleared to stop the worker
+        Progress _progress; // Used to abort the board being generated on exit
+        std::thread _worker; // MUST BE LAST: started once everything else is initialized
+
+        // Fill the ring until it is full, then sleep until a board is popped (or, if no board of
+        // the difficulty could be generated, until `pop()` is next called)
+        void work();
+
+    public:
+        // Start filling the ring with boards of a difficulty (or Any) from a seed index, which must
+        // outlive the pregenerator (it may be shared with other threads)
+        Pregenerator(SeedIndex &seeds, Difficulty difficulty = Difficulty::Any);
+
+        // Stop the worker (aborting the board it is working on) and wait for it
+        ~Pregenerator();
+
+        // Take a ready board if there is one; returns false (and wakes the worker) if the ring is
+        // empty
+        bool pop(Board &board);
+};
+
+#endif
@@ -0,0 +1,314 @@
+// All code from the namespace `std` is part of the C++ standard library
+// made publically available by an ISO working group
+#include <algorithm>
+#include <bit>
+
+#include "rater.hpp"
+#include "trace.hpp"
+#include "units.hpp"
+
+// Lookup tables shared by every Rater, built once at startup (see units.hpp for the rest)
+static struct Tables {
+    std::uint16_t combos[4][84]; // 9-bit masks with 2 or 3 bits set (indexed by bit count)
+    int numCombos[4] = {}; // The number of masks in each list of `combos`
+
+    Tables() {
+        for (int mask = 0; mask < 512; ++mask) {
+            int bits = std::popcount((unsigned int) mask);
+            if (bits == 2 || bits == 3)
+                combos[bits][numCombos[bits]++] = mask;
+        }
+    }
+} tables;
+
+// Bit for a number (1-9)
+static std::uint16_t bit(int num) {
+    return 1 << (num - 1);
+}
+
+static const char *names[] = {
+    "hidden-single", "naked-single", "locked-candidates", "naked-pair", "naked-triple",
+    "hidden-pair", "hidden-triple", "x-wing", "swordfish", "guess", "invalid"
+};
+
+std::string techniqueName(Technique technique) {
+    return names[technique];
+}
+
+Technique techniqueFromName(const std::string &name) {
+    for (int i = 0; i < Technique::Invalid; ++i)
+        if (name == names[i])
+            return (Technique) i;
+
+    return Technique::Invalid;
+}
+
+void Rater::place(int cell, int num) {
+    _values[cell] = num;
+    _candidates[cell] = 0;
+    --_left;
+
+    for (int peer : unitTables.peers[cell])
+        _candidates[peer] &= ~bit(num);
+}
+
+bool Rater::eliminate(int cell, std::uint16_t mask) {
+    if (!(_candidates[cell] & mask))
+        return false;
+
+    _candidates[cell] &= ~mask;
+    return true;
+}
+
+std::uint16_t Rater::positions(int unit, int num) const {
+    std::uint16_t mask = 0;
+    for (int i = 0; i < 9; ++i)
+        if (_candidates[unitTables.units[unit][i]] & bit(num))
+            mask |= 1 << i;
+
+    return mask;
+}
+
+bool Rater::nakedSingles() {
+    bool progress = false;
+
+    for (int cell = 0; cell < 81; ++cell) {
+        if (std::popcount(_candidates[cell]) == 1) {
+            place(cell, std::countr_zero(_candidates[cell]) + 1);
+            progress = true;
+        }
+    }
+
+    return progress;
+}
+
+bool Rater::hiddenSingles() {
+    bool progress = false;
+
+    for (int unit = 0; unit < 27; ++unit) {
+        // Find the numbers that fit in exactly one cell of the unit
+        std::uint16_t once = 0, twice = 0;
+        for (int cell : unitTables.units[unit]) {
+            twice |= once & _candidates[cell];
+            once |= _candidates[cell];
+        }
+
+        for (std::uint16_t single = once & ~twice; single; single &= single - 1) {
+            std::uint16_t mask = single & -single;
+
+            // Placing an earlier number may have taken the cell, so check it still fits
+            for (int cell : unitTables.units[unit]) {
+                if (_candidates[cell] & mask) {
+                    place(cell, std::countr_zero(mask) + 1);
+                    progress = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    return progress;
+}
+
+bool Rater::lockedCandidates() {
+    bool progress = false;
+
+    for (int num = 1; num < 10; ++num) {
+        // Pointing: if a number in a group is confined to one row or column, it can't be
+        // anywhere else in that row or column
+        for (int group = 0; group < 9; ++group) {
+            std::uint16_t mask = positions(18 + group, num);
+            if (!mask)
+                continue;
+
+            for (int k = 0; k < 3; ++k) {
+                int line = -1;
+                if (!(mask & ~(0b111 << (3 * k))))
+                    line = (group / 3) * 3 + k; // A row
+                else if (!(mask & ~(0b001001001 << k)))
+                    line = 9 + (group % 3) * 3 + k; // A column
+                else
+                    continue;
+
+                for (int cell : unitTables.units[line])
+                    if (unitTables.unitsOf[cell][2] != 18 + group)
+                        progress |= eliminate(cell, bit(num));
+            }
+        }
+
+        // Claiming: if a number in a row or column is confined to one group, it can't be
+        // anywhere else in that group
+        for (int line = 0; line < 18; ++line) {
+            std::uint16_t mask = positions(line, num);
+            if (!mask)
+                continue;
+
+            for (int k = 0; k < 3; ++k) {
+                if (mask & ~(0b111 << (3 * k)))
+                    continue;
+
+                int group = unitTables.unitsOf[unitTables.units[line][3 * k]][2];
+                for (int cell : unitTables.units[group])
+                    if (unitTables.unitsOf[cell][0] != line && unitTables.unitsOf[cell][1] != line)
+                        progress |= eliminate(cell, bit(num));
+            }
+        }
+    }
+
+    return progress;
+}
+
+bool Rater::nakedSubsets(int size) {
+    bool progress = false;
+
+    for (int unit = 0; unit < 27; ++unit) {
+        for (int c = 0; c < tables.numCombos[size]; ++c) {
+            std::uint16_t cells = tables.combos[size][c], numbers = 0;
+
+            // Every chosen cell must be empty
+            bool empty = true;
+            for (int i = 0; i < 9; ++i) {
+                if (cells & (1 << i)) {
+                    empty &= _values[unitTables.units[unit][i]] == 0;
+                    numbers |= _candidates[unitTables.units[unit][i]];
+                }
+            }
+
+            // `size` cells that can only hold `size` numbers take them from the rest of the unit
+            if (!empty || std::popcount(numbers) != size)
+                continue;
+
+            for (int i = 0; i < 9; ++i)
+                if (!(cells & (1 << i)))
+                    progress |= eliminate(unitTables.units[unit][i], numbers);
+        }
+    }
+
+    return progress;
+}
+
+bool Rater::hiddenSubsets(int size) {
+    bool progress = false;
+
+    for (int unit = 0; unit < 27; ++unit) {
+        std::uint16_t where[9];
+        for (int num = 1; num < 10; ++num)
+            where[num - 1] = positions(unit, num);
+
+        for (int c = 0; c < tables.numCombos[size]; ++c) {
+            std::uint16_t numbers = tables.combos[size][c], cells = 0;
+
+            // Every chosen number must still need a cell
+            bool missing = true;
+            for (int i = 0; i < 9; ++i) {
+                if (numbers & (1 << i)) {
+                    missing &= where[i] != 0;
+                    cells |= where[i];
+                }
+            }
+
+            // `size` numbers that only fit in `size` cells leave no room for anything else
+            if (!missing || std::popcount(cells) != size)
+                continue;
+
+            for (int i = 0; i < 9; ++i)
+                if (cells & (1 << i))
+                    progress |= eliminate(unitTables.units[unit][i], ~numbers & 0x1ff);
+        }
+    }
+
+    return progress;
+}
+
+bool Rater::fish(int size) {
+    bool progress = false;
+
+    for (int num = 1; num < 10; ++num) {
+        // Look for the number in rows confined to columns (base 0), then the other way around
+        for (int base = 0; base < 18; base += 9) {
+            int cover = 9 - base;
+
+            std::uint16_t where[9];
+            for (int i = 0; i < 9; ++i)
+                where[i] = positions(base + i, num);
+
+            for (int c = 0; c < tables.numCombos[size]; ++c) {
+                std::uint16_t lines = tables.combos[size][c], covered = 0;
+
+                bool missing = true;
+                for (int i = 0; i < 9; ++i) {
+                    if (lines & (1 << i)) {
+                        missing &= where[i] != 0;
+                        covered |= where[i];
+                    }
+                }
+
+                // `size` lines whose only places for the number share `size` cover lines
+                // leave no room for it anywhere else in those cover lines
+                if (!missing || std::popcount(covered) != size)
+                    continue;
+
+                for (int j = 0; j < 9; ++j)
+                    if (covered & (1 << j))
+                        for (int i = 0; i < 9; ++i)
+                            if (!(lines & (1 << i)))
+                                progress |= eliminate(unitTables.units[cover + j][i], bit(num));
+            }
+        }
+    }
+
+    return progress;
+}
+
+Technique Rater::rate(const Board &board) {
+    Trace::Span span("Rater::rate");
+
+    if (!board.validate())
+        return Technique::Invalid;
+
+    // Start from every cell being able to hold anything, then place the board's numbers
+    _left = 81;
+    for (int cell = 0; cell < 81; ++cell) {
+        _values[cell] = 0;
+        _candidates[cell] = 0x1ff;
+    }
+
+    for (int cell = 0; cell < 81; ++cell)
+        if (board[cell / 9][cell % 9] > 0)
+            place(cell, board[cell / 9][cell % 9]);
+
+    // Always use the easiest technique that makes progress
+    Technique hardest = Technique::HiddenSingle;
+    while (_left > 0) {
+        // An empty cell that can't hold anything means there is no solution
+        for (int cell = 0; cell < 81; ++cell)
+            if (_values[cell] == 0 && _candidates[cell] == 0)
+                return Technique::Invalid;
+
+        Technique used;
+        if (hiddenSingles())
+            used = Technique::HiddenSingle;
+        else if (nakedSingles())
+            used = Technique::NakedSingle;
+        else if (lockedCandidates())
+            used = Technique::LockedCandidates;
+        else if (nakedSubsets(2))
+            used = Technique::NakedPair;
+        else if (nakedSubsets(3))
+            used = Technique::NakedTriple;
+        else if (hiddenSubsets(2))
+            used = Technique::HiddenPair;
+        else if (hiddenSubsets(3))
+            used = Technique::HiddenTriple;
+        else if (fish(2))
+            used = Technique::XWing;
+        else if (fish(3))
+            used = Technique::Swordfish;
+        else
+            return Technique::Guess;
+
+        hardest = std::max(hardest, used);
+    }
+
+    return hardest;
+}
@@ -0,0 +1,58 @@
+#ifndef SUDOKU_RATER_HPP
+#define SUDOKU_RATER_HPP
+
+// All code from the namespace `std` is part of the C++ standard library
+// made publically available by an ISO working group
+#include <cstdint>
+#include <string>
+
+#include "board.hpp"
+
+// The techniques a human uses to solve a board, from easiest to hardest
+// A board is rated by the hardest technique it needs
+enum Technique {
+    HiddenSingle, // The only cell in a row, column, or group that can hold a number
+    NakedSingle, // The only number a cell can hold
+    LockedCandidates, // Pointing (group -> row/column) and claiming (row/column -> group)
+    NakedPair, NakedTriple, // 2/3 cells of a row, column, or group that can only hold 2/3 numbers
+    HiddenPair, HiddenTriple, // 2/3 numbers of a row, column, or group that fit in only 2/3 cells
+    XWing, Swordfish, // A number confined to the same 2/3 columns in 2/3 rows (or vice versa)
+    Guess, // None of the above are enough: solving needs trial and error
+    Invalid // Numbers repeat or there is no solution
+};
+
+// A readable name for a technique (e.g. "x-wing") and back; returns Invalid for unknown names
+std::string techniqueName(Technique technique);
+Technique techniqueFromName(const std::string &name);
+
+// Rates boards by solving them with human techniques, tracking candidates as bitmasks
+// Keeps no state between boards, but is cheap to construct so use one per thread
+class Rater {
+    private:
+        int _values[81]; // The number in each cell (0 if empty)
+        std::uint16_t _candidates[81]; // Bit n - 1 is set if the cell can hold n (0 if filled)
+        int _left; // The number of empty cells
+
+        // Fill a cell and remove the number from the candidates of its row, column, and group
+        void place(int cell, int num);
+
+        // Remove numbers (as a mask) from a cell; returns true if any were removed
+        bool eliminate(int cell, std::uint16_t mask);
+
+        // A 9-bit mask of the cells of `unit` that can hold `num`
+        std::uint16_t positions(int unit, int num) const;
+
+        // Each technique makes one pass over the board and returns true if it made progress
+        bool nakedSingles();
+        bool hiddenSingles();
+        bool lockedCandidates();
+        bool nakedSubsets(int size);
+        bool hiddenSubsets(int size);
+        bool fish(int size);
+
+    public:
+        // Returns the hardest technique needed to solve `board`
+        Technique rate(const Board &board);
+};
+
+#endif
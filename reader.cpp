@@ -0,0 +1,136 @@
+// All code from the namespace `std` is part of the C++ standard library
+// made publically available by an ISO working group
+#include <algorithm>
+#include <cstring>
+
+// POSIX APIs for memory mapping
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "reader.hpp"
+
+PuzzleReader::PuzzleReader(const std::string &file, std::uint64_t from) {
+    int fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    // Map the file rather than reading it: lines are parsed where they are
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        void *mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            madvise(mapped, info.st_size, MADV_SEQUENTIAL);
+            _mapped = mapped;
+            _data = (const char *) mapped;
+            _size = info.st_size;
+        }
+    }
+    close(fd);
+
+    _position = std::min<std::uint64_t>(from, _size);
+}
+
+PuzzleReader::PuzzleReader(const char *text, std::size_t size) : _data(text), _size(size) {}
+
+PuzzleReader::~PuzzleReader() {
+    if (_mapped)
+        munmap(_mapped, _size);
+}
+
+// Characters allowed between the cells of a puzzle
+static bool separator(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '|' || c == '+' || c == '-';
+}
+
+bool PuzzleReader::next(Board &board) {
+    int cells = 0; // The number of cells of the puzzle read so far
+    std::size_t started = 0; // Where the puzzle starts
+
+    while (_position < _size) {
+        std::size_t line = _position;
+        const char *newline = (const char *) std::memchr(_data + line, '\n', _size - line);
+        std::size_t eol = newline ? newline - _data : _size;
+        _position = newline ? eol + 1 : _size;
+
+        // Read the cells on this line straight into the board, stopping at anything else (or at
+        // whitespace once the puzzle is complete, where an annotation may follow)
+        int num = 0; // The number of cells on this line
+        bool tooMany = false;
+        std::size_t i = line;
+        for (; i < eol; ++i) {
+            char c = _data[i];
+            if (cells + num == 81 && (c == ' ' || c == '\t' || c == '\r'))
+                break;
+            if (separator(c))
+                continue;
+            if ((c < '0' || c > '9') && c != '.')
+                break;
+            if (cells + num == 81) {
+                tooMany = true;
+                break;
+            }
+
+            int cell = cells + num++;
+            board._board[cell / 9][cell % 9] = c == '.' ? 0 : c - '0';
+        }
+
+        // Skip blank lines, comments, and separator lines
+        if (num == 0 && (i == eol || _data[i] == '#'))
+            continue;
+
+        // Anything but a comment or annotation, or the wrong number of cells, spoils the puzzle
+        ParseError error = { line, "" };
+        if (i < eol && _data[i] != '#' && cells + num < 81)
+            error = { i, std::string("unexpected '") + _data[i] + "'" };
+        else if (tooMany)
+            error.message = "more than 81 cells";
+        else if (cells == 0 && num != 81 && num != 9)
+            error.message = "expected 81 cells or a row of 9, found " + std::to_string(num);
+        else if (cells > 0 && num != 9)
+            error.message = "expected a row of 9 cells, found " + std::to_string(num);
+
+        if (!error.message.empty()) {
+            _errors.push_back(error);
+            cells = 0;
+            continue;
+        }
+
+        if (cells == 0)
+            started = line;
+        cells += num;
+        if (cells < 81)
+            continue;
+
+        // Keep whatever follows the puzzle on its line (unless it's a comment)
+        std::size_t first = i, last = eol;
+        while (first < last && separator(_data[first]))
+            ++first;
+        while (last > first && (_data[last - 1] == ' ' || _data[last - 1] == '\t' ||
+                                _data[last - 1] == '\r'))
+            --last;
+        _annotation = first < last && _data[first] != '#' ?
+                      std::string_view(_data + first, last - first) : std::string_view();
+
+        _start = started;
+        _end = _position;
+        board._numFixed = 0;
+        return true;
+    }
+
+    // The input ended partway through a grid
+    if (cells > 0)
+        _errors.push_back({ started, "incomplete grid: " + std::to_string(cells / 9) +
+                                     " of 9 rows" });
+
+    return false;
+}
+
+std::uint64_t PuzzleReader::complete() const {
+    for (std::size_t i = _size; i > 0; --i)
+        if (_data[i - 1] == '\n')
+            return i;
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+#ifndef SUDOKU_READER_HPP
+#define SUDOKU_READER_HPP
+
+// All code from the namespace `std` is part of the C++ standard library
+// made publically available by an ISO working group
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "board.hpp"
+
+// A line that couldn't be read as (part of) a puzzle
+struct ParseError {
+    std::uint64_t offset; // Where the problem is, in bytes from the start of the input
+    std::string message;
+};
+
+// Reads puzzles one at a time from a file (memory mapped) or text in memory, straight into a
+// Board, without copying any lines. Understands:
+//   - one puzzle per line: 81 cells, then optionally whitespace and an annotation (e.g. the
+//     rating written by `-r`)
+//   - grids: 9 lines of 9 cells, with any of ` |+-` between cells and separator lines between
+//     rows (e.g. `4 . . | . . . | 8 . 5` and `------+-------+------`)
+//   - `1`-`9` for numbers and `0` or `.` for blanks
+//   - blank lines and comments (from `#` to the end of the line)
+// Malformed lines are skipped and recorded in `errors()` with their offsets.
+class PuzzleReader {
+    private:
+        const char *_data = nullptr; // The input
+        std::size_t _size = 0; // The length of the input
+        void *_mapped = nullptr; // The mapping of the file (nullptr for text or empty files)
+        std::size_t _position = 0; // Where the next line starts
+
+        std::uint64_t _start = 0; // Where the last puzzle read starts
+        std::uint64_t _end = 0; // Just past the end of the line the last puzzle read ends on
+        std::string_view _annotation; // Whatever follows the last puzzle read on its line
+        std::vector<ParseError> _errors; // Every malformed line so far
+
+    public:
+        // Read a file starting `from` bytes in; a missing file reads as empty
+        explicit PuzzleReader(const std::string &file, std::uint64_t from = 0);
+
+        // Read `size` bytes of text that stay alive (and unchanged) as long as the reader
+        // (Not a std::string_view, so a std::string can only ever mean a file name)
+        PuzzleReader(const char *text, std::size_t size);
+
+        // Unmap the file
+        ~PuzzleReader();
+
+        // Owns the mapping, so it can't be copied
+        PuzzleReader(const PuzzleReader &) = delete;
+        PuzzleReader& operator=(const PuzzleReader &) = delete;
+
+        // Read the next puzzle into `board` (which is left with nothing fixed)
+        // Returns false once there are no puzzles left
+        bool next(Board &board);
+
+        // Where the last puzzle read starts, and where the line it ends on ends (past the newline)
+        std::uint64_t start() const {
+            return _start;
+        }
+        std::uint64_t end() const {
+            return _end;
+        }
+
+        // The text after the last puzzle read on its line, without surrounding whitespace
+        // Empty if there was none or it was a comment. Only valid as long as the reader
+        std::string_view annotation() const {
+            return _annotation;
+        }
+
+        // The length of the input (as it was when the file was opened)
+        std::uint64_t size() const {
+            return _size;
+        }
+
+        // Where the input ends, not counting a last line with no newline yet (which may still be
+        // being written by another process)
+        std::uint64_t complete() const;
+
+        // Every malformed line skipped so far
+        const std::vector<ParseError>& errors() const {
+            return _errors;
+        }
+};
+
+#endif
@@ -0,0 +1,256 @@
+// All code from the namespace `std` is part of the C++ standard library
+// made publically available by an ISO working group
+#include <fstream>
+#include <random>
+#include <sstream>
+
+// POSIX APIs for reading a single seed without reading the whole file, and for telling
+// when the seeds file was replaced
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "filelock.hpp"
+#include "reader.hpp"
+#include "seedindex.hpp"
+#include "trace.hpp"
+
+static const char *names[] = { "easy", "medium", "hard", "expert", "extreme", "any" };
+
+Difficulty difficultyOf(Technique technique) {
+    switch (technique) {
+        case Technique::HiddenSingle:
+        case Technique::NakedSingle:
+            return Difficulty::Easy;
+        case Technique::LockedCandidates:
+            return Difficulty::Medium;
+        case Technique::NakedPair:
+        case Technique::NakedTriple:
+        case Technique::HiddenPair:
+        case Technique::HiddenTriple:
+            return Difficulty::Hard;
+        case Technique::XWing:
+        case Technique::Swordfish:
+            return Difficulty::Expert;
+        case Technique::Guess:
+            return Difficulty::Extreme;
+        default:
+            return Difficulty::Any;
+    }
+}
+
+std::string difficultyName(Difficulty difficulty) {
+    return names[difficulty];
+}
+
+Difficulty difficultyFromName(const std::string &name) {
+    for (int i = 0; i < Difficulty::Any; ++i)
+        if (name == names[i])
+            return (Difficulty) i;
+
+    return Difficulty::Any;
+}
+
+SeedIndex::SeedIndex(std::string seeds) : _seeds(seeds), _index(seeds + ".idx") {
+    Trace::Span span("SeedIndex::SeedIndex");
+
+    // Leave no index or lock file behind for a seeds file that doesn't exist (yet)
+    if (access(_seeds.c_str(), F_OK) != 0)
+        return;
+
+    FileLock lock(_seeds + ".lock");
+    sync();
+}
+
+void SeedIndex::clear() {
+    _covered = 0;
+    _read = 0;
+    for (int i = 0; i < Difficulty::Any; ++i) {
+        _byDifficulty[i].clear();
+        for (std::vector<std::uint64_t> &bucket : _byClues[i])
+            bucket.clear();
+    }
+}
+
+std::size_t SeedIndex::sync() {
+    // A replaced seeds file (e.g. by -r) comes with a new index, so load that from the start
+    struct stat info = {};
+    stat(_seeds.c_str(), &info);
+    if ((std::uint64_t) info.st_dev != _device || (std::uint64_t) info.st_ino != _inode)
+        clear();
+
+    // Start over if the seeds file no longer matches the index
+    if (!load()) {
+        clear();
+        std::ofstream(_index, std::ios::out | std::ios::binary | std::ios::trunc);
+    }
+
+    std::size_t added = scan();
+
+    _device = info.st_dev;
+    _inode = info.st_ino;
+    _size = info.st_size;
+    return added;
+}
+
+void SeedIndex::add(std::uint64_t offset, Technique technique, int clues) {
+    // Boards that can't be served aren't indexed
+    Difficulty difficulty = difficultyOf(technique);
+    if (difficulty == Difficulty::Any)
+        return;
+
+    _byDifficulty[difficulty].push_back(offset);
+    _byClues[difficulty][clues].push_back(offset);
+}
+
+bool SeedIndex::load() {
+    std::ifstream index_file(_index, std::ios::in | std::ios::binary);
+    index_file.seekg(_read);
+
+    std::ifstream seeds_file(_seeds, std::ios::in | std::ios::binary | std::ios::ate);
+    std::uint64_t size = seeds_file ? (std::uint64_t) seeds_file.tellg() : 0;
+
+    // Load every complete entry, checking that each fits the seeds file
+    std::string line;
+    bool loaded = false;
+    std::uint64_t last = 0; // The offset of the last seed loaded
+    while (std::getline(index_file, line) && !index_file.eof()) {
+        std::istringstream entry(line);
+        std::uint64_t offset;
+        std::string technique;
+        int clues;
+
+        if (!(entry >> offset >> technique >> clues) || offset < _covered || offset + 81 > size ||
+            clues < 0 || clues > 81)
+            return false;
+
+        add(offset, techniqueFromName(technique), clues);
+        _covered = offset + 81;
+        _read += line.size() + 1;
+        last = offset;
+        loaded = true;
+    }
+
+    // The index ends at the end of the line holding its last seed, which must still be there
+    if (loaded) {
+        PuzzleReader reader(_seeds, last);
+        Board seed;
+        if (!reader.next(seed) || reader.start() != last || reader.end() > reader.complete())
+            return false;
+        _covered = reader.end();
+    }
+
+    return true;
+}
+
+std::size_t SeedIndex::update() {
+    Trace::Span span("SeedIndex::update");
+
+    std::lock_guard<std::mutex> guard(_using);
+    if (access(_seeds.c_str(), F_OK) != 0)
+        return 0;
+
+    FileLock lock(_seeds + ".lock");
+    return sync();
+}
+
+std::size_t SeedIndex::scan() {
+    Trace::Span span("SeedIndex::scan");
+
+    PuzzleReader reader(_seeds, _covered);
+    std::ofstream index_file(_index, std::ios::out | std::ios::binary | std::ios::app);
+
+    Rater rater;
+    Board board;
+    std::size_t added = 0;
+    while (reader.next(board)) {
+        // Leave a line that is still being written (no newline yet) for the next update
+        if (reader.end() > reader.complete())
+            break;
+        _covered = reader.end();
+
+        // Use the rating written by `-r` if there is one
+        Technique technique = techniqueFromName(std::string(reader.annotation()));
+        if (technique == Technique::Invalid)
+            technique = rater.rate(board);
+
+        std::ostringstream entry;
+        entry << reader.start() << ' ' << techniqueName(technique) << ' ' << board.count() << '\n';
+        index_file << entry.str();
+        _read += entry.str().size();
+
+        add(reader.start(), technique, board.count());
+        ++added;
+    }
+
+    index_file.close();
+    return added;
+}
+
+std::size_t SeedIndex::size(Difficulty difficulty) const {
+    std::lock_guard<std::mutex> guard(_using);
+
+    if (difficulty != Difficulty::Any)
+        return _byDifficulty[difficulty].size();
+
+    std::size_t total = 0;
+    for (const std::vector<std::uint64_t> &bucket : _byDifficulty)
+        total += bucket.size();
+
+    return total;
+}
+
+bool SeedIndex::pick(Board &seed, Difficulty difficulty, int clues) {
+    Trace::Span span("SeedIndex::pick");
+
+    std::lock_guard<std::mutex> guard(_using);
+
+    // Catch up on seeds other processes appended (e.g. with -g) or a replaced file (e.g. by -r)
+    struct stat info;
+    if (stat(_seeds.c_str(), &info) == 0 &&
+        ((std::uint64_t) info.st_size != _size || (std::uint64_t) info.st_dev != _device ||
+         (std::uint64_t) info.st_ino != _inode)) {
+        FileLock lock(_seeds + ".lock");
+        sync();
+    }
+
+    // Gather the buckets that match (at most one per difficulty)
+    const std::vector<std::uint64_t> *buckets[Difficulty::Any];
+    int numBuckets = 0;
+    std::size_t total = 0;
+    for (int i = 0; i < Difficulty::Any; ++i) {
+        if (difficulty != Difficulty::Any && difficulty != i)
+            continue;
+
+        buckets[numBuckets] = clues > 0 && clues <= 81 ? &_byClues[i][clues] : &_byDifficulty[i];
+        total += buckets[numBuckets++]->size();
+    }
+
+    if (total == 0)
+        return false;
+
+    // To generate better random numbers
+    std::random_device dev;
+    std::mt19937 rng(dev());
+    std::uniform_int_distribution<std::size_t> dist(0, total - 1);
+
+    // Find the bucket the chosen seed falls in
+    std::size_t chosen = dist(rng);
+    int b = 0;
+    while (chosen >= buckets[b]->size())
+        chosen -= buckets[b++]->size();
+
+    // Read just that seed (enough bytes for a grid with separators and comments)
+    char buffer[1024];
+    int fd = open(_seeds.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    ssize_t got = pread(fd, buffer, sizeof(buffer), (*buckets[b])[chosen]);
+    close(fd);
+
+    if (got <= 0)
+        return false;
+
+    PuzzleReader reader(buffer, got);
+    return reader.next(seed);
+}
@@ -0,0 +1,82 @@
+#ifndef SUDOKU_SEEDINDEX_HPP
+#define SUDOKU_SEEDINDEX_HPP
+
+// All code from the namespace `std` is part of the C++ standard library
+// made publically available by an ISO working group
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "board.hpp"
+#include "rater.hpp"
+
+// The tier a technique puts a board in
+Difficulty difficultyOf(Technique technique);
+
+// A readable name for a difficulty (e.g. "hard") and back; returns Any for unknown names
+std::string difficultyName(Difficulty difficulty);
+Difficulty difficultyFromName(const std::string &name);
+
+// Groups the seeds in a seeds file by difficulty and number of clues so a seed of either can be
+// picked in constant time. The index lives next to the seeds file (`<seeds>.idx`), one line
+// per seed: `<offset> <technique> <clues>`. Seeds may be in any format `PuzzleReader` reads.
+// Seeds appended to the seeds file are rated and added to the end of the index by `update()`
+// (which `pick()` calls whenever the seeds file has grown or been replaced). It holds
+// `<seeds>.lock` so several processes can share the index; files rewritten in place (e.g. by
+// `-r`) must remove the index so it is rebuilt. Neither file is created until the seeds file
+// exists. One SeedIndex may be used by several threads.
+class SeedIndex {
+    private:
+        std::string _seeds; // The seeds file
+        std::string _index; // The index file
+        std::uint64_t _covered = 0; // How many bytes of the seeds file are indexed
+        std::uint64_t _read = 0; // How many bytes of the index file are loaded
+        std::uint64_t _device = 0, _inode = 0; // Which seeds file was indexed (it may be replaced)
+        std::uint64_t _size = 0; // How big the seeds file was when it was last indexed
+        mutable std::mutex _using; // Held by whichever thread is picking or updating
+        std::vector<std::uint64_t> _byDifficulty[Difficulty::Any]; // Seed offsets per tier
+        std::vector<std::uint64_t> _byClues[Difficulty::Any][82]; // Seed offsets per tier + clues
+
+        // Add a seed to the in-memory buckets
+        void add(std::uint64_t offset, Technique technique, int clues);
+
+        // Load the entries past `_read` (some may have been added by other processes)
+        // Returns false if they don't match the seeds file
+        bool load();
+
+        // Rate and index the seeds past `_covered` (the lock must be held)
+        std::size_t scan();
+
+        // Forget every loaded entry
+        void clear();
+
+        // Bring the index up to date with the seeds file, starting over if the seeds file was
+        // replaced or no longer matches the index (the lock and `_using` must be held)
+        // Returns the number of seeds added to the index file
+        std::size_t sync();
+
+    public:
+        // Load the index for the seeds file and bring it up to date
+        SeedIndex(std::string seeds = "seeds.dat");
+
+        // Index any seeds appended to the seeds file since the last update
+        // Seeds already rated by `-r` keep their rating; the others are rated now
+        // Returns the number of seeds added
+        std::size_t update();
+
+        // The seeds file
+        const std::string& file() const {
+            return _seeds;
+        }
+
+        // The number of indexed seeds of a difficulty (Any for all of them)
+        std::size_t size(Difficulty difficulty = Difficulty::Any) const;
+
+        // Read a random seed of a difficulty (Any for any difficulty) and optionally a number of
+        // clues (0 for any number) into `seed`; returns false if there are no such seeds
+        // Updates the index first if the seeds file has changed since the last update
+        bool pick(Board &seed, Difficulty difficulty = Difficulty::Any, int clues = 0);
+};
+
+#endif
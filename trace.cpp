@@ -0,0 +1,88 @@
+// All code from the namespace `std` is part of the C++ standard library
+// made publically available by an ISO working group
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <unistd.h>
+
+#include "trace.hpp"
+
+// One finished span
+struct Event {
+    const char *name;
+    std::int64_t begin, end;
+    long arg;
+};
+
+// The events of one thread. Only that thread adds to it, so its lock is never contended
+// except by `stop()`
+struct Buffer {
+    int thread;
+    std::mutex lock;
+    std::vector<Event> events;
+};
+
+std::atomic<bool> Trace::_enabled = false;
+
+static std::string file; // Where to write the events
+static std::chrono::steady_clock::time_point started; // When recording started
+static std::mutex registering; // Guards `buffers`
+static std::vector<std::unique_ptr<Buffer>> buffers; // Every thread's buffer (kept after exit)
+
+std::int64_t Trace::now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started).count();
+}
+
+void Trace::record(const char *name, std::int64_t begin, std::int64_t end, long arg) {
+    // Spans that started before `stop()` but end after it are dropped
+    if (!enabled())
+        return;
+
+    // Each thread registers its buffer the first time it records something
+    thread_local Buffer *buffer = nullptr;
+    if (!buffer) {
+        std::lock_guard<std::mutex> guard(registering);
+        buffers.push_back(std::make_unique<Buffer>());
+        buffer = buffers.back().get();
+        buffer->thread = buffers.size();
+    }
+
+    std::lock_guard<std::mutex> guard(buffer->lock);
+    buffer->events.push_back({name, begin, end, arg});
+}
+
+void Trace::start(std::string path) {
+    file = path;
+    started = std::chrono::steady_clock::now();
+    _enabled = true;
+}
+
+void Trace::stop() {
+    if (!_enabled.exchange(false))
+        return;
+
+    std::ofstream out(file, std::ios::out | std::ios::trunc);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    // Complete ("X") events, one per span
+    bool first = true;
+    std::lock_guard<std::mutex> guard(registering);
+    for (std::unique_ptr<Buffer> &buffer : buffers) {
+        std::lock_guard<std::mutex> events(buffer->lock);
+        for (const Event &event : buffer->events) {
+            out << (first ? "\n" : ",\n") << "{\"name\":\"" << event.name << "\",\"ph\":\"X\","
+                << "\"ts\":" << event.begin << ",\"dur\":" << event.end - event.begin
+                << ",\"pid\":" << getpid() << ",\"tid\":" << buffer->thread;
+            if (event.arg >= 0)
+                out << ",\"args\":{\"arg\":" << event.arg << "}";
+            out << "}";
+            first = false;
+        }
+    }
+
+    out << "\n]}\n";
+}
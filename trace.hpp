@@ -0,0 +1,60 @@
+#ifndef SUDOKU_TRACE_HPP
+#define SUDOKU_TRACE_HPP
+
+// All code from the namespace `std` is part of the C++ standard library
+// made publically available by an ISO working group
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Records how long things take as Chrome trace events (open the file in chrome://tracing or
+// https://ui.perfetto.dev). Recording is off, and spans cost a single check, until `start()`
+class Trace {
+    private:
+        static std::atomic<bool> _enabled; // Whether spans are being recorded
+
+        // Microseconds since recording started
+        static std::int64_t now();
+
+        // Add a finished span to the calling thread's buffer
+        static void record(const char *name, std::int64_t begin, std::int64_t end, long arg);
+
+    public:
+        // Start recording; the events are written to `file` by `stop()`
+        static void start(std::string file);
+
+        // Stop recording and write every thread's events to the file given to `start()`
+        // Safe to call while other threads are still running spans (they are no longer recorded)
+        static void stop();
+
+        // Whether spans are being recorded
+        static bool enabled() {
+            return _enabled.load(std::memory_order_relaxed);
+        }
+
+        // Records the time between its construction and destruction as one event
+        // `name` must outlive the trace (use a string literal); nullptr records nothing
+        class Span {
+            private:
+                const char *_name; // The name of the event (nullptr if not recording)
+                long _arg; // A number to attach to the event (-1 for none)
+                std::int64_t _begin = 0; // When the span started
+
+            public:
+                Span(const char *name, long arg = -1) : _name(enabled() ? name : nullptr),
+                                                        _arg(arg) {
+                    if (_name)
+                        _begin = now();
+                }
+
+                ~Span() {
+                    if (_name)
+                        record(_name, _begin, now(), _arg);
+                }
+
+                Span(const Span &copy) = delete;
+                Span& operator=(const Span &copy) = delete;
+        };
+};
+
+#endif
@@ -0,0 +1,31 @@
+// All code from the namespace `std` is part of the C++ standard library
+// made publically available by an ISO working group
+#include <algorithm>
+
+#include "units.hpp"
+
+const UnitTables unitTables;
+
+UnitTables::UnitTables() {
+    for (int i = 0; i < 9; ++i) {
+        for (int j = 0; j < 9; ++j) {
+            units[i][j] = i * 9 + j;
+            units[9 + i][j] = j * 9 + i;
+            units[18 + i][j] = ((i / 3) * 3 + j / 3) * 9 + (i % 3) * 3 + j % 3;
+        }
+    }
+
+    for (int cell = 0; cell < 81; ++cell) {
+        unitsOf[cell][0] = cell / 9;
+        unitsOf[cell][1] = 9 + cell % 9;
+        unitsOf[cell][2] = 18 + (cell / 27) * 3 + (cell % 9) / 3;
+
+        // Every cell of its units except itself, without repeats
+        int num = 0;
+        for (int unit : unitsOf[cell])
+            for (int peer : units[unit])
+                if (peer != cell && std::find(peers[cell], peers[cell] + num, peer) ==
+                                    peers[cell] + num)
+                    peers[cell][num++] = peer;
+    }
+}
@@ -0,0 +1,16 @@
+#ifndef SUDOKU_UNITS_HPP
+#define SUDOKU_UNITS_HPP
+
+// The rows, columns, and groups ("units") of the board as lookup tables, built once at startup
+// Internal to the engine (shared by the rater and the lanes, not installed)
+struct UnitTables {
+    int units[27][9]; // The cells of each row (0-8), column (9-17), and group (18-26)
+    int unitsOf[81][3]; // The row, column, and group of each cell
+    int peers[81][20]; // The other cells in the same row, column, or group as each cell
+
+    UnitTables();
+};
+
+extern const UnitTables unitTables;
+
+#endif